@@ -22,6 +22,7 @@
 #include <display/state.h>
 #include <emuenv/state.h>
 #include <io/state.h>
+#include <kernel/state.h>
 #include <util/log.h>
 
 #include <SDL.h>
@@ -50,6 +51,9 @@ void calculate_fps(EmuEnvState &emuenv) {
         const uint32_t frame_count = static_cast<std::uint32_t>(emuenv.frame_count);
         emuenv.fps = (frame_count * 1000 + ms / 2) / ms;
         emuenv.ms_per_frame = (ms + frame_count / 2) / frame_count;
+        const uint64_t hle_call_count = emuenv.kernel.hle_call_count.load(std::memory_order_relaxed);
+        emuenv.hle_calls_per_sec = ((hle_call_count - emuenv.last_hle_call_count) * 1000 + ms / 2) / ms;
+        emuenv.last_hle_call_count = hle_call_count;
         emuenv.sdl_ticks = sdl_ticks_now;
         emuenv.frame_count = 0;
         set_window_title(emuenv);
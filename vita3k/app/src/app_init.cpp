@@ -160,6 +160,10 @@ void update_viewport(EmuEnvState &state) {
         SDL_Vulkan_GetDrawableSize(state.window.get(), &w, &h);
         break;
 
+    case renderer::Backend::Null:
+        SDL_GetWindowSize(state.window.get(), &w, &h);
+        break;
+
     default:
         LOG_ERROR("Unimplemented backend render: {}.", static_cast<int>(state.renderer->current_backend));
         break;
@@ -386,8 +390,12 @@ bool init(EmuEnvState &state, const Root &root_paths) {
 #else
         state.backend_renderer = renderer::Backend::OpenGL;
 #endif
+    } else if (string_utils::toupper(state.cfg.current_config.backend_renderer) == "NULL") {
+        state.backend_renderer = renderer::Backend::Null;
     }
 
+    state.display.uncapped_vblank = state.cfg.uncapped_vblank;
+
     int window_type = 0;
     switch (state.backend_renderer) {
     case renderer::Backend::OpenGL:
@@ -398,6 +406,11 @@ bool init(EmuEnvState &state, const Root &root_paths) {
         window_type = SDL_WINDOW_VULKAN;
         break;
 
+    case renderer::Backend::Null:
+        // nothing is ever shown
+        window_type = SDL_WINDOW_HIDDEN;
+        break;
+
     default:
         LOG_ERROR("Unimplemented backend render: {}.", state.cfg.backend_renderer);
         break;
@@ -139,6 +139,7 @@ public:
         bool v_sync = true;
         int anisotropic_filtering = 1;
         bool async_pipeline_compilation = true;
+        bool async_texture_decode = true;
         bool import_textures = false;
         bool export_textures = false;
         bool export_as_png = false;
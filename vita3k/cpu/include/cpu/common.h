@@ -41,12 +41,14 @@ typedef std::function<Address(Address)> GetWatchMemoryAddr;
 typedef std::unique_ptr<CPUState, std::function<void(CPUState *)>> CPUStatePtr;
 typedef std::unique_ptr<CPUInterface> CPUInterfacePtr;
 typedef void *ExclusiveMonitorPtr;
+typedef void *SharedJitCachePtr;
 
 struct CPUProtocolBase {
     virtual void call_svc(CPUState &cpu, uint32_t svc, Address pc, ThreadState &thread) = 0;
     virtual Address get_watch_memory_addr(Address addr) = 0;
 #ifdef USE_DYNARMIC
     virtual ExclusiveMonitorPtr get_exlusive_monitor() = 0;
+    virtual SharedJitCachePtr get_shared_jit_cache() = 0;
 #endif
     virtual ~CPUProtocolBase() = default;
 };
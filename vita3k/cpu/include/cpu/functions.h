@@ -62,6 +62,11 @@ ExclusiveMonitorPtr new_exclusive_monitor(int max_num_cores);
 void free_exclusive_monitor(ExclusiveMonitorPtr monitor);
 void clear_exclusive(ExclusiveMonitorPtr monitor, std::size_t core_num);
 
+// Translated code shared between all the threads, see DynarmicJitCache
+SharedJitCachePtr new_shared_jit_cache(MemState &mem, ExclusiveMonitorPtr monitor, bool cpu_opt, std::size_t first_processor_id, std::size_t max_instances);
+void free_shared_jit_cache(SharedJitCachePtr cache);
+void invalidate_shared_jit_cache(SharedJitCachePtr cache, Address start, size_t length);
+
 // Debugging helpers
 std::string disassemble(CPUState &state, uint64_t at, bool thumb, uint16_t *insn_size = nullptr);
 std::string disassemble(CPUState &state, uint64_t at, uint16_t *insn_size = nullptr);
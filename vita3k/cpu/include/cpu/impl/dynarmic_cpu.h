@@ -28,22 +28,75 @@
 #include <cpu/impl/unicorn_cpu.h>
 #endif
 
+#include <array>
+#include <atomic>
 #include <functional>
 #include <memory>
+#include <mutex>
 
 class ArmDynarmicCallback;
 class ArmDynarmicCP15;
+class DynarmicCPU;
+
+/*! \brief A JIT instance (with its translated blocks) that can be borrowed by any guest thread */
+struct DynarmicJitSlot {
+    std::unique_ptr<ArmDynarmicCallback> cb;
+    std::shared_ptr<ArmDynarmicCP15> cp15;
+    std::unique_ptr<Dynarmic::A32::Jit> jit;
+    std::size_t index = 0;
+    std::size_t processor_id = 0;
+    std::atomic<bool> in_use = false;
+};
+
+/**
+ * \brief Process-wide pool of JIT instances shared by all guest threads.
+ *
+ * A thread only borrows a slot while it is executing guest code and gives it back on every
+ * SVC/halt, so the number of JIT instances (and copies of the translated code) is bounded by
+ * the number of threads running at the same time instead of the number of threads created.
+ */
+class DynarmicJitCache {
+    static constexpr std::size_t MAX_SLOTS = 32;
+
+    std::mutex mutex;
+    std::array<std::unique_ptr<DynarmicJitSlot>, MAX_SLOTS> slots;
+    std::atomic<std::size_t> slot_count = 0;
+
+    MemState &mem;
+    Dynarmic::ExclusiveMonitor *monitor;
+    std::size_t first_processor_id;
+    std::size_t max_slots;
+    bool cpu_opt;
+
+public:
+    DynarmicJitCache(MemState &mem, Dynarmic::ExclusiveMonitor *monitor, bool cpu_opt, std::size_t first_processor_id, std::size_t max_slots);
+    ~DynarmicJitCache();
+
+    // Return nullptr if all the slots are in use and the pool can't grow anymore
+    DynarmicJitSlot *acquire(DynarmicCPU &cpu, std::size_t preferred_slot);
+    void release(DynarmicJitSlot *slot);
+    void invalidate(Address start, size_t length);
+};
 
 class DynarmicCPU : public CPUInterface {
     friend class ArmDynarmicCallback;
+    friend class DynarmicJitCache;
 
     CPUState *parent;
 
-    std::unique_ptr<Dynarmic::A32::Jit> jit;
+    // Currently active JIT, either own_jit or the one of the borrowed shared slot.
+    // nullptr when the thread is parked, in which case the registers live in context
+    Dynarmic::A32::Jit *jit = nullptr;
+    std::unique_ptr<Dynarmic::A32::Jit> own_jit;
     std::unique_ptr<ArmDynarmicCallback> cb;
     std::shared_ptr<ArmDynarmicCP15> cp15;
     Dynarmic::ExclusiveMonitor *monitor;
 
+    DynarmicJitCache *shared_cache = nullptr;
+    DynarmicJitSlot *slot = nullptr;
+    std::size_t last_slot = 0;
+    Dynarmic::A32::Context context;
+
     std::size_t core_id = 0;
 
     bool exit_request = false;
@@ -55,9 +108,15 @@ class DynarmicCPU : public CPUInterface {
     bool cpu_opt;
 
     std::unique_ptr<Dynarmic::A32::Jit> make_jit();
+    void update_own_jit();
+    void attach_shared_jit();
+    void detach_shared_jit();
+
+    std::array<std::uint32_t, 16> &regs();
+    std::array<std::uint32_t, 64> &ext_regs();
 
 public:
-    DynarmicCPU(CPUState *state, std::size_t processor_id, Dynarmic::ExclusiveMonitor *monitor, bool cpu_opt);
+    DynarmicCPU(CPUState *state, std::size_t processor_id, Dynarmic::ExclusiveMonitor *monitor, bool cpu_opt, DynarmicJitCache *shared_cache = nullptr);
     ~DynarmicCPU() override;
     int run() override;
     void stop() override;
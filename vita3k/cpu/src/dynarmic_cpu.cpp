@@ -25,6 +25,8 @@
 
 #include <mem/ptr.h>
 
+#include <algorithm>
+
 //#include <dynarmic/frontend/A32/a32_ir_emitter.h>
 
 class ArmDynarmicCP15 : public Dynarmic::A32::Coprocessor {
@@ -294,38 +296,170 @@ public:
     }
 };
 
-std::unique_ptr<Dynarmic::A32::Jit> DynarmicCPU::make_jit() {
+static std::unique_ptr<Dynarmic::A32::Jit> create_jit(MemState &mem, ArmDynarmicCallback *cb, const std::shared_ptr<ArmDynarmicCP15> &cp15, Dynarmic::ExclusiveMonitor *monitor, std::size_t processor_id, bool cpu_opt, bool log_mem) {
     Dynarmic::A32::UserConfig config;
     config.arch_version = Dynarmic::A32::ArchVersion::v7;
-    config.callbacks = cb.get();
-    if (parent->mem->use_page_table) {
-        config.page_table = (log_mem || !cpu_opt) ? nullptr : reinterpret_cast<decltype(config.page_table)>(parent->mem->page_table.get());
+    config.callbacks = cb;
+    if (mem.use_page_table) {
+        config.page_table = (log_mem || !cpu_opt) ? nullptr : reinterpret_cast<decltype(config.page_table)>(mem.page_table.get());
         config.absolute_offset_page_table = true;
     } else {
-        config.fastmem_pointer = (log_mem || !cpu_opt) ? nullptr : parent->mem->memory.get();
+        config.fastmem_pointer = (log_mem || !cpu_opt) ? nullptr : mem.memory.get();
     }
     config.hook_hint_instructions = true;
     config.enable_cycle_counting = false;
     config.global_monitor = monitor;
     config.coprocessors[15] = cp15;
-    config.processor_id = core_id;
+    config.processor_id = processor_id;
     config.optimizations = cpu_opt ? Dynarmic::all_safe_optimizations : Dynarmic::no_optimizations;
     config.enable_cycle_counting = false;
 
     return std::make_unique<Dynarmic::A32::Jit>(config);
 }
 
-DynarmicCPU::DynarmicCPU(CPUState *state, std::size_t processor_id, Dynarmic::ExclusiveMonitor *monitor, bool cpu_opt)
+DynarmicJitCache::DynarmicJitCache(MemState &mem, Dynarmic::ExclusiveMonitor *monitor, bool cpu_opt, std::size_t first_processor_id, std::size_t max_slots)
+    : mem(mem)
+    , monitor(monitor)
+    , first_processor_id(first_processor_id)
+    , max_slots(std::min(max_slots, MAX_SLOTS))
+    , cpu_opt(cpu_opt) {
+}
+
+DynarmicJitCache::~DynarmicJitCache() {
+}
+
+DynarmicJitSlot *DynarmicJitCache::acquire(DynarmicCPU &cpu, std::size_t preferred_slot) {
+    const auto try_acquire = [&](std::size_t idx) -> DynarmicJitSlot * {
+        DynarmicJitSlot *slot = slots[idx].get();
+        bool expected = false;
+        if (slot->in_use.load(std::memory_order_relaxed) || !slot->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire))
+            return nullptr;
+        return slot;
+    };
+
+    // reuse the slot this thread ran on last time if possible, its code cache is the most likely to be warm
+    std::size_t count = slot_count.load(std::memory_order_acquire);
+    if (preferred_slot < count) {
+        if (DynarmicJitSlot *slot = try_acquire(preferred_slot))
+            return slot;
+    }
+    for (std::size_t i = 0; i < count; i++) {
+        if (DynarmicJitSlot *slot = try_acquire(i))
+            return slot;
+    }
+
+    // every slot is busy, grow the pool
+    const std::lock_guard<std::mutex> guard(mutex);
+    count = slot_count.load(std::memory_order_relaxed);
+    if (count >= max_slots)
+        return nullptr;
+
+    auto slot = std::make_unique<DynarmicJitSlot>();
+    slot->cb = std::make_unique<ArmDynarmicCallback>(*cpu.parent, cpu);
+    slot->cp15 = std::make_shared<ArmDynarmicCP15>();
+    slot->index = count;
+    slot->processor_id = first_processor_id + count;
+    slot->jit = create_jit(mem, slot->cb.get(), slot->cp15, monitor, slot->processor_id, cpu_opt, false);
+    slot->in_use = true;
+
+    DynarmicJitSlot *result = slot.get();
+    slots[count] = std::move(slot);
+    slot_count.store(count + 1, std::memory_order_release);
+    LOG_DEBUG("Shared JIT cache grown to {} instance(s)", count + 1);
+
+    return result;
+}
+
+void DynarmicJitCache::release(DynarmicJitSlot *slot) {
+    // the next thread to use this slot must not inherit our exclusive reservation
+    monitor->ClearProcessor(slot->processor_id);
+    slot->in_use.store(false, std::memory_order_release);
+}
+
+void DynarmicJitCache::invalidate(Address start, size_t length) {
+    // InvalidateCacheRange can be called while the jit is running on another thread:
+    // the invalidation is deferred and the jit halts with HaltReason::CacheInvalidation
+    const std::lock_guard<std::mutex> guard(mutex);
+    const std::size_t count = slot_count.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < count; i++)
+        slots[i]->jit->InvalidateCacheRange(start, length);
+}
+
+std::unique_ptr<Dynarmic::A32::Jit> DynarmicCPU::make_jit() {
+    return create_jit(*parent->mem, cb.get(), cp15, monitor, core_id, cpu_opt, log_mem);
+}
+
+void DynarmicCPU::update_own_jit() {
+    // logging needs a dedicated config, so a thread using it leaves the shared cache
+    const bool use_own_jit = !shared_cache || log_mem || log_code;
+    if (!use_own_jit) {
+        if (own_jit) {
+            own_jit->SaveContext(context);
+            own_jit.reset();
+        }
+        jit = nullptr;
+        return;
+    }
+
+    const Dynarmic::A32::Context ctx = own_jit ? own_jit->SaveContext() : context;
+    own_jit = make_jit();
+    own_jit->LoadContext(ctx);
+    jit = own_jit.get();
+}
+
+void DynarmicCPU::attach_shared_jit() {
+    if (own_jit)
+        return;
+
+    slot = shared_cache->acquire(*this, last_slot);
+    if (!slot) {
+        // the pool is exhausted, fall back to a private jit for this thread
+        LOG_WARN("Shared JIT cache is full, thread {} uses its own JIT", parent->thread_id);
+        own_jit = make_jit();
+        own_jit->LoadContext(context);
+        jit = own_jit.get();
+        return;
+    }
+
+    last_slot = slot->index;
+    slot->cb->parent = parent;
+    slot->cb->cpu = this;
+    slot->cp15->set_tpidruro(cp15->get_tpidruro());
+    slot->jit->LoadContext(context);
+    jit = slot->jit.get();
+}
+
+void DynarmicCPU::detach_shared_jit() {
+    if (!slot)
+        return;
+
+    jit->SaveContext(context);
+    jit = nullptr;
+    shared_cache->release(slot);
+    slot = nullptr;
+}
+
+std::array<std::uint32_t, 16> &DynarmicCPU::regs() {
+    return jit ? jit->Regs() : context.Regs();
+}
+
+std::array<std::uint32_t, 64> &DynarmicCPU::ext_regs() {
+    return jit ? jit->ExtRegs() : context.ExtRegs();
+}
+
+DynarmicCPU::DynarmicCPU(CPUState *state, std::size_t processor_id, Dynarmic::ExclusiveMonitor *monitor, bool cpu_opt, DynarmicJitCache *shared_cache)
     : parent(state)
     , cb(std::make_unique<ArmDynarmicCallback>(*state, *this))
     , cp15(std::make_shared<ArmDynarmicCP15>())
     , monitor(monitor)
+    , shared_cache(shared_cache)
     , core_id(processor_id)
     , cpu_opt(cpu_opt) {
-    jit = make_jit();
+    update_own_jit();
 }
 
 DynarmicCPU::~DynarmicCPU() {
+    detach_shared_jit();
 }
 
 int DynarmicCPU::run() {
@@ -333,17 +467,21 @@ int DynarmicCPU::run() {
     break_ = false;
     exit_request = false;
     parent->svc_called = false;
+    attach_shared_jit();
     Dynarmic::HaltReason halt_reason;
     do {
         halt_reason = jit->Run();
     } while (halt_reason == Dynarmic::HaltReason::Step || halt_reason == Dynarmic::HaltReason::CacheInvalidation);
+    detach_shared_jit();
 
     return halted;
 }
 
 int DynarmicCPU::step() {
     parent->svc_called = false;
+    attach_shared_jit();
     jit->Step();
+    detach_shared_jit();
     return 0;
 }
 
@@ -361,7 +499,7 @@ void DynarmicCPU::set_log_code(bool log) {
         return;
 
     log_code = log;
-    jit = make_jit();
+    update_own_jit();
 }
 
 void DynarmicCPU::set_log_mem(bool log) {
@@ -369,7 +507,7 @@ void DynarmicCPU::set_log_mem(bool log) {
         return;
 
     log_mem = log;
-    jit = make_jit();
+    update_own_jit();
 }
 
 bool DynarmicCPU::get_log_code() {
@@ -385,23 +523,26 @@ void DynarmicCPU::stop() {
 }
 
 uint32_t DynarmicCPU::get_reg(uint8_t idx) {
-    return jit->Regs()[idx];
+    return regs()[idx];
 }
 
 uint32_t DynarmicCPU::get_sp() {
-    return jit->Regs()[13];
+    return regs()[13];
 }
 
 uint32_t DynarmicCPU::get_pc() {
-    return jit->Regs()[15];
+    return regs()[15];
 }
 
 void DynarmicCPU::set_reg(uint8_t idx, uint32_t val) {
-    jit->Regs()[idx] = val;
+    regs()[idx] = val;
 }
 
 void DynarmicCPU::set_cpsr(uint32_t val) {
-    jit->SetCpsr(val);
+    if (jit)
+        jit->SetCpsr(val);
+    else
+        context.SetCpsr(val);
 }
 
 uint32_t DynarmicCPU::get_tpidruro() {
@@ -410,6 +551,8 @@ uint32_t DynarmicCPU::get_tpidruro() {
 
 void DynarmicCPU::set_tpidruro(uint32_t val) {
     cp15->set_tpidruro(val);
+    if (slot)
+        slot->cp15->set_tpidruro(val);
 }
 
 void DynarmicCPU::set_pc(uint32_t val) {
@@ -420,32 +563,35 @@ void DynarmicCPU::set_pc(uint32_t val) {
         set_cpsr(get_cpsr() & 0xFFFFFFDF);
         val = val & 0xFFFFFFFC;
     }
-    jit->Regs()[15] = val;
+    regs()[15] = val;
 }
 
 void DynarmicCPU::set_lr(uint32_t val) {
-    jit->Regs()[14] = val;
+    regs()[14] = val;
 }
 
 void DynarmicCPU::set_sp(uint32_t val) {
-    jit->Regs()[13] = val;
+    regs()[13] = val;
 }
 
 uint32_t DynarmicCPU::get_cpsr() {
-    return jit->Cpsr();
+    return jit ? jit->Cpsr() : context.Cpsr();
 }
 
 uint32_t DynarmicCPU::get_fpscr() {
-    return jit->Fpscr();
+    return jit ? jit->Fpscr() : context.Fpscr();
 }
 
 void DynarmicCPU::set_fpscr(uint32_t val) {
-    jit->SetFpscr(val);
+    if (jit)
+        jit->SetFpscr(val);
+    else
+        context.SetFpscr(val);
 }
 
 CPUContext DynarmicCPU::save_context() {
     CPUContext ctx;
-    const auto dctx = jit->SaveContext();
+    const auto dctx = jit ? jit->SaveContext() : context;
     ctx.cpu_registers = dctx.Regs();
     static_assert(sizeof(ctx.fpu_registers) == sizeof(dctx.ExtRegs()));
     memcpy(ctx.fpu_registers.data(), dctx.ExtRegs().data(), sizeof(ctx.fpu_registers));
@@ -462,23 +608,26 @@ void DynarmicCPU::load_context(CPUContext ctx) {
     memcpy(dctx.ExtRegs().data(), ctx.fpu_registers.data(), sizeof(ctx.fpu_registers));
     dctx.SetCpsr(ctx.cpsr);
     dctx.SetFpscr(ctx.fpscr);
-    jit->LoadContext(dctx);
+    if (jit)
+        jit->LoadContext(dctx);
+    else
+        context = dctx;
 }
 
 uint32_t DynarmicCPU::get_lr() {
-    return jit->Regs()[14];
+    return regs()[14];
 }
 
 float DynarmicCPU::get_float_reg(uint8_t idx) {
-    return reinterpret_cast<float &>(jit->ExtRegs()[idx]);
+    return reinterpret_cast<float &>(ext_regs()[idx]);
 }
 
 void DynarmicCPU::set_float_reg(uint8_t idx, float val) {
-    jit->ExtRegs()[idx] = reinterpret_cast<uint32_t &>(val);
+    ext_regs()[idx] = reinterpret_cast<uint32_t &>(val);
 }
 
 bool DynarmicCPU::is_thumb_mode() {
-    return jit->Cpsr() & 0x20;
+    return get_cpsr() & 0x20;
 }
 
 std::size_t DynarmicCPU::processor_id() const {
@@ -486,7 +635,9 @@ std::size_t DynarmicCPU::processor_id() const {
 }
 
 void DynarmicCPU::invalidate_jit_cache(Address start, size_t length) {
-    jit->InvalidateCacheRange(start, length);
+    // the shared cache is invalidated once for all threads by invalidate_shared_jit_cache
+    if (own_jit)
+        own_jit->InvalidateCacheRange(start, length);
 }
 
 // TODO: proper abstraction
@@ -503,3 +654,18 @@ void clear_exclusive(ExclusiveMonitorPtr monitor, std::size_t core_num) {
     Dynarmic::ExclusiveMonitor *monitor_ = reinterpret_cast<Dynarmic::ExclusiveMonitor *>(monitor);
     monitor_->ClearProcessor(core_num);
 }
+
+SharedJitCachePtr new_shared_jit_cache(MemState &mem, ExclusiveMonitorPtr monitor, bool cpu_opt, std::size_t first_processor_id, std::size_t max_instances) {
+    Dynarmic::ExclusiveMonitor *monitor_ = reinterpret_cast<Dynarmic::ExclusiveMonitor *>(monitor);
+    return new DynarmicJitCache(mem, monitor_, cpu_opt, first_processor_id, max_instances);
+}
+
+void free_shared_jit_cache(SharedJitCachePtr cache) {
+    DynarmicJitCache *cache_ = reinterpret_cast<DynarmicJitCache *>(cache);
+    delete cache_;
+}
+
+void invalidate_shared_jit_cache(SharedJitCachePtr cache, Address start, size_t length) {
+    DynarmicJitCache *cache_ = reinterpret_cast<DynarmicJitCache *>(cache);
+    cache_->invalidate(start, length);
+}
@@ -75,6 +75,10 @@ struct DisplayState {
     // or run twice as fast (if they only rely on these function calls for their timings)
     bool fps_hack = false;
 
+    // if set to true, a vblank happens as soon as it is waited for instead of every 1/60th of a second
+    // this lets the app run as fast as the host can emulate it, to measure the emulation speed
+    bool uncapped_vblank = false;
+
     // should contain the list of sync objects / swapchain images (in the order they appear in the cycle)
     std::vector<PredictedDisplayFrame> predicted_frames;
     // position in the predicted_frame cycle (the -1 is needed)
@@ -36,6 +36,21 @@ static constexpr int64_t TARGET_MICRO_PER_FRAME = 1000000LL / TARGET_FPS;
 static constexpr int predict_threshold = 3;
 static constexpr int max_expected_swapchain_size = 6;
 
+// must be called with display.mutex held
+static void wake_vblank_waiters(DisplayState &display) {
+    for (std::size_t i = 0; i < display.vblank_wait_infos.size();) {
+        auto &vblank_wait_info = display.vblank_wait_infos[i];
+        if (vblank_wait_info.target_vcount <= display.vblank_count) {
+            ThreadStatePtr target_wait = vblank_wait_info.target_thread;
+
+            target_wait->update_status(ThreadStatus::run);
+            display.vblank_wait_infos.erase(display.vblank_wait_infos.begin() + i);
+        } else {
+            i++;
+        }
+    }
+}
+
 static void vblank_sync_thread(EmuEnvState &emuenv) {
     DisplayState &display = emuenv.display;
 
@@ -64,17 +79,7 @@ static void vblank_sync_thread(EmuEnvState &emuenv) {
             for (auto &cb : display.vblank_callbacks)
                 cb.second->event_notify(cb.second->get_notifier_id());
 
-            for (std::size_t i = 0; i < display.vblank_wait_infos.size();) {
-                auto &vblank_wait_info = display.vblank_wait_infos[i];
-                if (vblank_wait_info.target_vcount <= display.vblank_count) {
-                    ThreadStatePtr target_wait = vblank_wait_info.target_thread;
-
-                    target_wait->update_status(ThreadStatus::run);
-                    display.vblank_wait_infos.erase(display.vblank_wait_infos.begin() + i);
-                } else {
-                    i++;
-                }
-            }
+            wake_vblank_waiters(display);
         }
         const auto time_ms = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
         const auto time_left = TARGET_MICRO_PER_FRAME - (time_ms % TARGET_MICRO_PER_FRAME);
@@ -100,6 +105,13 @@ void wait_vblank(DisplayState &display, KernelState &kernel, const ThreadStatePt
             if (target_vcount <= display.vblank_count)
                 return;
 
+            if (display.uncapped_vblank) {
+                // don't wait for the host clock, the vblank happens right now
+                display.vblank_count = target_vcount;
+                wake_vblank_waiters(display);
+                return;
+            }
+
             wait_thread->update_status(ThreadStatus::wait);
             display.vblank_wait_infos.push_back({ wait_thread, target_vcount });
         }
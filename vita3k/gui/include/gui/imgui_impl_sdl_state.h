@@ -32,20 +32,17 @@ struct ImGui_State {
     SDL_Window *window{};
     renderer::State *renderer{};
 
-    uint64_t time;
-    int MouseButtonsDown;
-    SDL_Cursor *MouseCursors[ImGuiMouseCursor_COUNT];
-    int PendingMouseLeaveFrame;
-    bool MouseCanUseGlobalState;
+    uint64_t time{};
+    int MouseButtonsDown{};
+    SDL_Cursor *MouseCursors[ImGuiMouseCursor_COUNT]{};
+    int PendingMouseLeaveFrame{};
+    bool MouseCanUseGlobalState{};
 
-    bool init;
-    bool is_typing;
-    bool do_clear_screen;
+    bool init{};
+    bool is_typing{};
+    bool do_clear_screen = true;
 
-    ImGui_State() {
-        memset((void *)this, 0, sizeof(*this));
-        do_clear_screen = true;
-    }
+    // no memset here, it would also clear the vptr of the polymorphic state
     virtual ~ImGui_State() = default;
 };
 
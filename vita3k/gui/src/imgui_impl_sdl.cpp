@@ -256,6 +256,13 @@ IMGUI_API ImGui_State *ImGui_ImplSdl_Init(renderer::State *renderer, SDL_Window
         state = reinterpret_cast<ImGui_State *>(ImGui_ImplSdlVulkan_Init(renderer, window));
         break;
 
+    case renderer::Backend::Null:
+        // the ui is still updated, but never rendered
+        state = new ImGui_State();
+        state->renderer = renderer;
+        state->window = window;
+        break;
+
     default:
         LOG_ERROR("Missing ImGui init for backend {}.", static_cast<int>(renderer->current_backend));
         return nullptr;
@@ -321,6 +328,9 @@ IMGUI_API void ImGui_ImplSdl_Shutdown(ImGui_State *state) {
     case renderer::Backend::Vulkan:
         return ImGui_ImplSdlVulkan_Shutdown(dynamic_cast<ImGui_VulkanState &>(*state));
 
+    case renderer::Backend::Null:
+        break;
+
     default:
         LOG_ERROR("Missing ImGui init for backend {}.", static_cast<int>(state->renderer->current_backend));
     }
@@ -500,6 +510,9 @@ IMGUI_API void ImGui_ImplSdl_RenderDrawData(ImGui_State *state) {
 
     case renderer::Backend::Vulkan:
         return ImGui_ImplSdlVulkan_RenderDrawData(dynamic_cast<ImGui_VulkanState &>(*state));
+
+    case renderer::Backend::Null:
+        return;
     }
 }
 
@@ -514,6 +527,10 @@ IMGUI_API void ImGui_ImplSdl_GetDrawableSize(ImGui_State *state, int &width, int
         SDL_Vulkan_GetDrawableSize(state->window, &width, &height);
         break;
 
+    case renderer::Backend::Null:
+        SDL_GetWindowSize(state->window, &width, &height);
+        break;
+
     default:
         LOG_ERROR("Missing ImGui init for backend {}.", static_cast<int>(state->renderer->current_backend));
     }
@@ -527,6 +544,9 @@ IMGUI_API ImTextureID ImGui_ImplSdl_CreateTexture(ImGui_State *state, void *data
     case renderer::Backend::Vulkan:
         return ImGui_ImplSdlVulkan_CreateTexture(dynamic_cast<ImGui_VulkanState &>(*state), data, width, height);
 
+    case renderer::Backend::Null:
+        return (void *)0;
+
     default:
         LOG_ERROR("Missing ImGui init for backend {}.", static_cast<int>(state->renderer->current_backend));
         return (void *)0;
@@ -541,6 +561,9 @@ IMGUI_API void ImGui_ImplSdl_DeleteTexture(ImGui_State *state, ImTextureID textu
     case renderer::Backend::Vulkan:
         return ImGui_ImplSdlVulkan_DeleteTexture(dynamic_cast<ImGui_VulkanState &>(*state), texture);
 
+    case renderer::Backend::Null:
+        return;
+
     default:
         LOG_ERROR("Missing ImGui init for backend {}.", static_cast<int>(state->renderer->current_backend));
     }
@@ -555,6 +578,9 @@ IMGUI_API void ImGui_ImplSdl_InvalidateDeviceObjects(ImGui_State *state) {
     case renderer::Backend::Vulkan:
         return ImGui_ImplSdlVulkan_InvalidateDeviceObjects(dynamic_cast<ImGui_VulkanState &>(*state));
 
+    case renderer::Backend::Null:
+        return;
+
     default:
         LOG_ERROR("Missing ImGui init for backend {}.", static_cast<int>(state->renderer->current_backend));
     }
@@ -567,6 +593,10 @@ IMGUI_API bool ImGui_ImplSdl_CreateDeviceObjects(ImGui_State *state) {
     case renderer::Backend::Vulkan:
         return ImGui_ImplSdlVulkan_CreateDeviceObjects(dynamic_cast<ImGui_VulkanState &>(*state));
 
+    case renderer::Backend::Null:
+        // the font atlas must still be built for the ui to be updated
+        return ImGui::GetIO().Fonts->Build();
+
     default:
         LOG_ERROR("Missing ImGui init for backend {}.", static_cast<int>(state->renderer->current_backend));
         return false;
@@ -683,6 +683,8 @@ IMGUI_API ImTextureID ImGui_ImplSdlVulkan_CreateTexture(ImGui_VulkanState &state
         1, &image_shader_read_only_barrier // Image Memory Barriers
     );
 
+    // transfer_queue is the queue the scenes are submitted to by the submit thread
+    vk_state.wait_for_submissions();
     vkutil::end_single_time_command(vk_state.device, vk_state.transfer_queue, vk_state.transfer_command_pool, transfer_buffer);
     vk_state.allocator.destroyBuffer(temp_buffer, temp_allocation);
 
@@ -706,6 +708,8 @@ IMGUI_API void ImGui_ImplSdlVulkan_DeleteTexture(ImGui_VulkanState &state, ImTex
     auto texture_ptr = reinterpret_cast<TextureState *>(texture);
     auto &vk_state = get_renderer(state);
 
+    // the device can't be waited on while the submit thread may use the queue
+    vk_state.wait_for_submissions();
     vk_state.device.waitIdle();
     vk_state.device.destroy(texture_ptr->image_view);
     vk_state.allocator.destroyImage(texture_ptr->image, texture_ptr->allocation);
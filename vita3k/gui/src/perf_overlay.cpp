@@ -18,6 +18,7 @@
 #include "private.h"
 
 #include <config/state.h>
+#include <renderer/state.h>
 
 namespace gui {
 static const ImVec2 PERF_OVERLAY_PAD = ImVec2(12.f, 12.f);
@@ -45,7 +46,7 @@ static ImVec2 get_perf_pos(ImVec2 window_size, EmuEnvState &emuenv, ImVec2 scale
 
 static float get_perf_height(EmuEnvState &emuenv) {
     switch (emuenv.cfg.performance_overlay_detail) {
-    case MAXIMUM: return 143.f;
+    case MAXIMUM: return 215.f;
     case MEDIUM: return 85.f;
     case LOW:
     case MINIMUM:
@@ -65,7 +66,7 @@ void draw_perf_overlay(GuiState &gui, EmuEnvState &emuenv) {
     const auto MAIN_WINDOW_SIZE = ImVec2((emuenv.cfg.performance_overlay_detail == MINIMUM ? 105.5f : 162.f) * SCALE.x, get_perf_height(emuenv) * SCALE.y);
 
     const auto WINDOW_POS = get_perf_pos(MAIN_WINDOW_SIZE, emuenv, SCALE);
-    const auto WINDOW_SIZE = ImVec2((emuenv.cfg.performance_overlay_detail == MINIMUM ? 82.5f : 140.f) * SCALE.x, (emuenv.cfg.performance_overlay_detail <= LOW ? 40.f : 63.f) * SCALE.y);
+    const auto WINDOW_SIZE = ImVec2((emuenv.cfg.performance_overlay_detail == MINIMUM ? 82.5f : 140.f) * SCALE.x, (emuenv.cfg.performance_overlay_detail <= LOW ? 40.f : (emuenv.cfg.performance_overlay_detail == MAXIMUM ? 135.f : 63.f)) * SCALE.y);
 
     ImGui::SetNextWindowSize(MAIN_WINDOW_SIZE);
     ImGui::SetNextWindowPos(WINDOW_POS);
@@ -84,6 +85,15 @@ void draw_perf_overlay(GuiState &gui, EmuEnvState &emuenv) {
         ImGui::Separator();
         ImGui::Text("%s: %d %s: %d", lang["min"].c_str(), emuenv.min_fps, lang["max"].c_str(), emuenv.max_fps);
     }
+    if (emuenv.cfg.performance_overlay_detail == PerfomanceOverleyDetail::MAXIMUM) {
+        ImGui::Text("%s: %llu", lang["hle_calls"].c_str(), static_cast<unsigned long long>(emuenv.hle_calls_per_sec));
+        // uploaded / requested uniform storage of the last frame
+        const renderer::FrameStats &frame_stats = emuenv.renderer->last_frame_stats;
+        ImGui::Text("%s: %llu/%llu KiB", lang["uniforms"].c_str(), static_cast<unsigned long long>(frame_stats.uniform_bytes_uploaded / 1024),
+            static_cast<unsigned long long>(frame_stats.uniform_bytes_requested / 1024));
+        ImGui::Text("%s: %llu", lang["descriptor_writes"].c_str(), static_cast<unsigned long long>(frame_stats.descriptor_writes));
+        ImGui::Text("%s: %llu", lang["merged_draws"].c_str(), static_cast<unsigned long long>(frame_stats.merged_draws));
+    }
     ImGui::PopFont();
     ImGui::EndChild();
     ImGui::PopStyleVar();
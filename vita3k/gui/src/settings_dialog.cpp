@@ -182,6 +182,7 @@ static bool get_custom_config(EmuEnvState &emuenv, const std::string &app_path)
                 config.v_sync = gpu_child.attribute("v-sync").as_bool();
                 config.anisotropic_filtering = gpu_child.attribute("anisotropic-filtering").as_int();
                 config.async_pipeline_compilation = gpu_child.attribute("async-pipeline-compilation").as_bool();
+                config.async_texture_decode = gpu_child.attribute("async-texture-decode").as_bool();
                 config.import_textures = gpu_child.attribute("import-textures").as_bool();
                 config.export_textures = gpu_child.attribute("export-textures").as_bool();
                 config.export_as_png = gpu_child.attribute("export-as-png").as_bool();
@@ -255,6 +256,7 @@ void init_config(GuiState &gui, EmuEnvState &emuenv, const std::string &app_path
         config.v_sync = emuenv.cfg.v_sync;
         config.anisotropic_filtering = emuenv.cfg.anisotropic_filtering;
         config.async_pipeline_compilation = emuenv.cfg.async_pipeline_compilation;
+        config.async_texture_decode = emuenv.cfg.async_texture_decode;
         config.import_textures = emuenv.cfg.import_textures;
         config.export_textures = emuenv.cfg.export_textures;
         config.export_as_png = emuenv.cfg.export_as_png;
@@ -296,6 +298,8 @@ void init_config(GuiState &gui, EmuEnvState &emuenv, const std::string &app_path
 #ifndef __APPLE__
     if (string_utils::toupper(config.backend_renderer) == "OPENGL")
         emuenv.backend_renderer = renderer::Backend::OpenGL;
+    else if (string_utils::toupper(config.backend_renderer) == "NULL")
+        emuenv.backend_renderer = renderer::Backend::Null;
     else
         emuenv.backend_renderer = renderer::Backend::Vulkan;
 #else
@@ -354,6 +358,7 @@ static void save_config(GuiState &gui, EmuEnvState &emuenv) {
         gpu_child.append_attribute("v-sync") = config.v_sync;
         gpu_child.append_attribute("anisotropic-filtering") = config.anisotropic_filtering;
         gpu_child.append_attribute("async-pipeline-compilation") = config.async_pipeline_compilation;
+        gpu_child.append_attribute("async-texture-decode") = config.async_texture_decode;
         gpu_child.append_attribute("import-textures") = config.import_textures;
         gpu_child.append_attribute("export-textures") = config.export_textures;
         gpu_child.append_attribute("export-as-png") = config.export_as_png;
@@ -394,6 +399,7 @@ static void save_config(GuiState &gui, EmuEnvState &emuenv) {
         emuenv.cfg.v_sync = config.v_sync;
         emuenv.cfg.anisotropic_filtering = config.anisotropic_filtering;
         emuenv.cfg.async_pipeline_compilation = config.async_pipeline_compilation;
+        emuenv.cfg.async_texture_decode = config.async_texture_decode;
         emuenv.cfg.import_textures = config.import_textures;
         emuenv.cfg.export_textures = config.export_textures;
         emuenv.cfg.export_as_png = config.export_as_png;
@@ -462,6 +468,7 @@ void set_config(EmuEnvState &emuenv, const std::string &app_path, bool custom) {
         emuenv.cfg.current_config.v_sync = emuenv.cfg.v_sync;
         emuenv.cfg.current_config.anisotropic_filtering = emuenv.cfg.anisotropic_filtering;
         emuenv.cfg.current_config.async_pipeline_compilation = emuenv.cfg.async_pipeline_compilation;
+        emuenv.cfg.current_config.async_texture_decode = emuenv.cfg.async_texture_decode;
         emuenv.cfg.current_config.import_textures = emuenv.cfg.import_textures;
         emuenv.cfg.current_config.export_textures = emuenv.cfg.export_textures;
         emuenv.cfg.current_config.export_as_png = emuenv.cfg.export_as_png;
@@ -480,6 +487,8 @@ void set_config(EmuEnvState &emuenv, const std::string &app_path, bool custom) {
 #ifndef __APPLE__
     if (string_utils::toupper(emuenv.cfg.current_config.backend_renderer) == "OPENGL")
         emuenv.backend_renderer = renderer::Backend::OpenGL;
+    else if (string_utils::toupper(emuenv.cfg.current_config.backend_renderer) == "NULL")
+        emuenv.backend_renderer = renderer::Backend::Null;
     else
         emuenv.backend_renderer = renderer::Backend::Vulkan;
 #else
@@ -512,12 +521,14 @@ void set_config(EmuEnvState &emuenv, const std::string &app_path, bool custom) {
     emuenv.renderer->set_stretch_display(emuenv.cfg.stretch_the_display_area);
     emuenv.renderer->get_texture_cache()->set_replacement_state(emuenv.cfg.current_config.import_textures, emuenv.cfg.current_config.export_textures, emuenv.cfg.current_config.export_as_png);
     emuenv.renderer->set_async_compilation(emuenv.cfg.current_config.async_pipeline_compilation);
+    emuenv.renderer->get_texture_cache()->set_async_decode(emuenv.cfg.current_config.async_texture_decode);
     emuenv.display.fps_hack = emuenv.cfg.current_config.fps_hack;
 
     // No change it if app already running
     if (emuenv.io.title_id.empty()) {
         emuenv.kernel.cpu_backend = set_cpu_backend(emuenv.cfg.current_config.cpu_backend);
         emuenv.kernel.cpu_opt = emuenv.cfg.current_config.cpu_opt;
+        emuenv.kernel.cpu_shared_jit = emuenv.cfg.cpu_shared_jit;
         emuenv.audio.set_backend(emuenv.cfg.audio_backend);
     }
 
@@ -728,15 +739,18 @@ void draw_settings_dialog(GuiState &gui, EmuEnvState &emuenv) {
             if (ImGui::IsItemHovered())
                 ImGui::SetTooltip("%s", lang.gpu["surface_sync_description"].c_str());
 
-            if (is_vulkan)
-                ImGui::SameLine();
+            ImGui::SameLine();
         }
 
-        if (is_vulkan) {
-            ImGui::Checkbox(lang.gpu["async_pipeline_compilation"].c_str(), &config.async_pipeline_compilation);
-            if (ImGui::IsItemHovered())
-                ImGui::SetTooltip("%s", lang.gpu["async_pipeline_compilation_description"].c_str());
-        }
+        // on OpenGL, it is only used if the driver supports parallel shader compilation
+        ImGui::Checkbox(lang.gpu["async_pipeline_compilation"].c_str(), &config.async_pipeline_compilation);
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("%s", lang.gpu["async_pipeline_compilation_description"].c_str());
+        ImGui::SameLine();
+
+        ImGui::Checkbox(lang.gpu["async_texture_decode"].c_str(), &config.async_texture_decode);
+        if (ImGui::IsItemHovered())
+            ImGui::SetTooltip("%s", lang.gpu["async_texture_decode_description"].c_str());
 
         // Screen Filter
         ImGui::Spacing();
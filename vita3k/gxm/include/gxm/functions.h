@@ -49,6 +49,14 @@ bool is_paletted_format(SceGxmTextureBaseFormat base_format);
 bool is_yuv_format(SceGxmTextureBaseFormat base_format);
 uint32_t attribute_format_size(SceGxmAttributeFormat format);
 uint32_t index_element_size(SceGxmIndexFormat format);
+
+struct IndexRange {
+    uint32_t min;
+    uint32_t max;
+};
+
+// Smallest and biggest index used by an index buffer, vectorized when the cpu allows it
+IndexRange get_index_range(const void *indices, uint32_t count, SceGxmIndexFormat format);
 bool is_stream_instancing(SceGxmIndexSource source);
 bool convert_color_format_to_texture_format(SceGxmColorFormat format, SceGxmTextureFormat &dest_format);
 
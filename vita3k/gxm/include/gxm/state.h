@@ -23,6 +23,7 @@
 
 #include <map>
 #include <mutex>
+#include <unordered_map>
 
 struct SDL_Thread;
 
@@ -48,6 +49,18 @@ struct MemoryMapInfo {
     std::uint32_t perm;
 };
 
+// Max index of an index buffer, valid until the memory of the buffer gets written to
+struct IndexRangeCacheEntry {
+    SceGxmIndexFormat format;
+    uint32_t max_index = 0;
+    // write epoch of the buffer pages when it was last scanned
+    WriteEpoch write_epoch = 0;
+    uint32_t invalidation_count = 0;
+};
+
+// key is (index buffer address << 32) | index count
+typedef std::unordered_map<uint64_t, IndexRangeCacheEntry> IndexRangeCache;
+
 struct GxmState {
     SceGxmInitializeParams params;
 
@@ -64,4 +77,11 @@ struct GxmState {
 
     std::map<Address, MemoryMapInfo> memory_mapped_regions;
     std::mutex callback_lock;
+
+    // draws from different contexts can look up the cache concurrently
+    std::mutex index_range_cache_mutex;
+    IndexRangeCache index_range_cache;
+
+    // increased each time a vertex or fragment program is freed
+    std::atomic<uint32_t> program_release_count{ 0 };
 };
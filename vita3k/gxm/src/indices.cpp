@@ -0,0 +1,153 @@
+// Vita3K emulator project
+// Copyright (C) 2024 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+/*
+min/max scan of index buffers
+1 program compiled for aarch64: always use NEON
+2 x86: use AVX2 if the runtime cpu supports it, otherwise a scalar loop
+*/
+
+#include <gxm/functions.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace gxm {
+template <typename T>
+static IndexRange get_index_range_basic(const T *data, const uint32_t count) {
+    T min_index = std::numeric_limits<T>::max();
+    T max_index = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        min_index = std::min(min_index, data[i]);
+        max_index = std::max(max_index, data[i]);
+    }
+
+    return { min_index, max_index };
+}
+} // namespace gxm
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+
+namespace gxm {
+static IndexRange get_index_range_u16(const uint16_t *data, const uint32_t count) {
+    uint16x8_t min_vec = vdupq_n_u16(UINT16_MAX);
+    uint16x8_t max_vec = vdupq_n_u16(0);
+
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const uint16x8_t indices = vld1q_u16(data + i);
+        min_vec = vminq_u16(min_vec, indices);
+        max_vec = vmaxq_u16(max_vec, indices);
+    }
+
+    const IndexRange tail = get_index_range_basic(data + i, count - i);
+    return { std::min<uint32_t>(vminvq_u16(min_vec), tail.min), std::max<uint32_t>(vmaxvq_u16(max_vec), tail.max) };
+}
+
+static IndexRange get_index_range_u32(const uint32_t *data, const uint32_t count) {
+    uint32x4_t min_vec = vdupq_n_u32(UINT32_MAX);
+    uint32x4_t max_vec = vdupq_n_u32(0);
+
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const uint32x4_t indices = vld1q_u32(data + i);
+        min_vec = vminq_u32(min_vec, indices);
+        max_vec = vmaxq_u32(max_vec, indices);
+    }
+
+    const IndexRange tail = get_index_range_basic(data + i, count - i);
+    return { std::min(vminvq_u32(min_vec), tail.min), std::max(vmaxvq_u32(max_vec), tail.max) };
+}
+} // namespace gxm
+#else
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_AVX2 __attribute__((__target__("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER)
+#define TARGET_AVX2
+#include <intrin.h>
+#else
+#error "Compiler is not supported"
+#endif
+
+#include <util/instrset_detect.h>
+
+namespace gxm {
+static IndexRange TARGET_AVX2 get_index_range_u16_AVX2(const uint16_t *data, const uint32_t count) {
+    __m256i min_vec = _mm256_set1_epi16(-1);
+    __m256i max_vec = _mm256_setzero_si256();
+
+    uint32_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m256i indices = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        min_vec = _mm256_min_epu16(min_vec, indices);
+        max_vec = _mm256_max_epu16(max_vec, indices);
+    }
+
+    alignas(32) uint16_t mins[16];
+    alignas(32) uint16_t maxs[16];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(mins), min_vec);
+    _mm256_store_si256(reinterpret_cast<__m256i *>(maxs), max_vec);
+
+    const IndexRange tail = get_index_range_basic(data + i, count - i);
+    return { std::min<uint32_t>(*std::min_element(mins, mins + 16), tail.min), std::max<uint32_t>(*std::max_element(maxs, maxs + 16), tail.max) };
+}
+
+static IndexRange TARGET_AVX2 get_index_range_u32_AVX2(const uint32_t *data, const uint32_t count) {
+    __m256i min_vec = _mm256_set1_epi32(-1);
+    __m256i max_vec = _mm256_setzero_si256();
+
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i indices = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        min_vec = _mm256_min_epu32(min_vec, indices);
+        max_vec = _mm256_max_epu32(max_vec, indices);
+    }
+
+    alignas(32) uint32_t mins[8];
+    alignas(32) uint32_t maxs[8];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(mins), min_vec);
+    _mm256_store_si256(reinterpret_cast<__m256i *>(maxs), max_vec);
+
+    const IndexRange tail = get_index_range_basic(data + i, count - i);
+    return { std::min(*std::min_element(mins, mins + 8), tail.min), std::max(*std::max_element(maxs, maxs + 8), tail.max) };
+}
+
+static IndexRange get_index_range_u16(const uint16_t *data, const uint32_t count) {
+    static const bool has_avx2 = util::instrset::instrset_detect() >= util::instrset::instrset_AVX2;
+    return has_avx2 ? get_index_range_u16_AVX2(data, count) : get_index_range_basic(data, count);
+}
+
+static IndexRange get_index_range_u32(const uint32_t *data, const uint32_t count) {
+    static const bool has_avx2 = util::instrset::instrset_detect() >= util::instrset::instrset_AVX2;
+    return has_avx2 ? get_index_range_u32_AVX2(data, count) : get_index_range_basic(data, count);
+}
+} // namespace gxm
+#endif
+
+namespace gxm {
+IndexRange get_index_range(const void *indices, const uint32_t count, const SceGxmIndexFormat format) {
+    if (count == 0)
+        return { 0, 0 };
+
+    if (format == SCE_GXM_INDEX_FORMAT_U16)
+        return get_index_range_u16(static_cast<const uint16_t *>(indices), count);
+
+    return get_index_range_u32(static_cast<const uint32_t *>(indices), count);
+}
+} // namespace gxm
@@ -0,0 +1,100 @@
+// Vita3K emulator project
+// Copyright (C) 2024 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <gxm/functions.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+template <typename T>
+static std::vector<T> random_indices(const size_t count, const T max_value, const uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<uint32_t> dist(0, max_value);
+    std::vector<T> indices(count);
+    for (T &index : indices)
+        index = static_cast<T>(dist(rng));
+
+    return indices;
+}
+
+TEST(index_range, empty) {
+    const uint16_t data = 5;
+    const gxm::IndexRange range = gxm::get_index_range(&data, 0, SCE_GXM_INDEX_FORMAT_U16);
+    ASSERT_EQ(range.min, 0);
+    ASSERT_EQ(range.max, 0);
+}
+
+TEST(index_range, u16_matches_scalar) {
+    // every count from 1 to 100 to hit all the tail lengths of the vector loop
+    for (size_t count = 1; count <= 100; count++) {
+        const std::vector<uint16_t> indices = random_indices<uint16_t>(count, UINT16_MAX, static_cast<uint32_t>(count));
+        const gxm::IndexRange range = gxm::get_index_range(indices.data(), static_cast<uint32_t>(count), SCE_GXM_INDEX_FORMAT_U16);
+        ASSERT_EQ(range.min, *std::min_element(indices.begin(), indices.end()));
+        ASSERT_EQ(range.max, *std::max_element(indices.begin(), indices.end()));
+    }
+}
+
+TEST(index_range, u32_matches_scalar) {
+    for (size_t count = 1; count <= 100; count++) {
+        const std::vector<uint32_t> indices = random_indices<uint32_t>(count, UINT32_MAX, static_cast<uint32_t>(count));
+        const gxm::IndexRange range = gxm::get_index_range(indices.data(), static_cast<uint32_t>(count), SCE_GXM_INDEX_FORMAT_U32);
+        ASSERT_EQ(range.min, *std::min_element(indices.begin(), indices.end()));
+        ASSERT_EQ(range.max, *std::max_element(indices.begin(), indices.end()));
+    }
+}
+
+TEST(index_range, extremes_at_the_end) {
+    // the extremes are in the scalar tail, past the last full vector
+    std::vector<uint32_t> indices(67, 1000);
+    indices[65] = 0x80000001;
+    indices[66] = 3;
+    const gxm::IndexRange range = gxm::get_index_range(indices.data(), static_cast<uint32_t>(indices.size()), SCE_GXM_INDEX_FORMAT_U32);
+    ASSERT_EQ(range.min, 3);
+    ASSERT_EQ(range.max, 0x80000001);
+}
+
+// Not a correctness test: prints the scan throughput next to std::max_element for typical mesh sizes
+TEST(index_range, DISABLED_benchmark) {
+    constexpr size_t index_counts[] = { 96, 1536, 12288, 98304 };
+    constexpr int iterations = 2000;
+
+    for (const size_t count : index_counts) {
+        const std::vector<uint16_t> indices = random_indices<uint16_t>(count, static_cast<uint16_t>(std::min<size_t>(count, UINT16_MAX)), 42);
+
+        uint64_t sink = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++)
+            sink += gxm::get_index_range(indices.data(), static_cast<uint32_t>(count), SCE_GXM_INDEX_FORMAT_U16).max;
+        const auto vector_time = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++)
+            sink += *std::max_element(indices.begin(), indices.end());
+        const auto scalar_time = std::chrono::steady_clock::now() - start;
+
+        const auto ns_per_scan = [&](const std::chrono::steady_clock::duration time) {
+            return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count()) / iterations;
+        };
+        printf("u16 x %6zu: get_index_range %10.1f ns, std::max_element %10.1f ns (%llu)\n", count,
+            ns_per_scan(vector_time), ns_per_scan(scalar_time), static_cast<unsigned long long>(sink & 1));
+    }
+}
@@ -411,7 +411,10 @@ static ExitCode load_app_impl(SceUID &main_module_id, EmuEnvState &emuenv) {
     const auto call_import = [&emuenv](CPUState &cpu, uint32_t nid, SceUID thread_id) {
         ::call_import(emuenv, cpu, nid, thread_id);
     };
-    if (!emuenv.kernel.init(emuenv.mem, call_import, emuenv.kernel.cpu_backend, emuenv.kernel.cpu_opt)) {
+    const auto call_hle_import = [&emuenv](CPUState &cpu, uint32_t index, SceUID thread_id) {
+        ::call_hle_import(emuenv, cpu, index, thread_id);
+    };
+    if (!emuenv.kernel.init(emuenv.mem, call_import, call_hle_import, emuenv.kernel.cpu_backend, emuenv.kernel.cpu_opt)) {
         LOG_WARN("Failed to init kernel!");
         return KernelInitFailed;
     }
@@ -22,18 +22,25 @@
 struct KernelState;
 
 typedef std::function<void(CPUState &cpu, uint32_t nid, SceUID thread_id)> CallImportFunc;
+typedef std::function<void(CPUState &cpu, uint32_t index, SceUID thread_id)> CallHleImportFunc;
+
+// Import stubs of HLE functions use svc #(HLE_IMPORT_SVC_FLAG | import index)
+constexpr uint32_t HLE_IMPORT_SVC_FLAG = 0x800000;
+constexpr uint32_t HLE_IMPORT_SVC_INDEX_MASK = HLE_IMPORT_SVC_FLAG - 1;
 
 struct CPUProtocol : public CPUProtocolBase {
-    CPUProtocol(KernelState &kernel, MemState &mem, const CallImportFunc &func);
+    CPUProtocol(KernelState &kernel, MemState &mem, const CallImportFunc &func, const CallHleImportFunc &hle_func);
     ~CPUProtocol() override = default;
     void call_svc(CPUState &cpu, uint32_t svc, Address pc, ThreadState &thread) override;
     Address get_watch_memory_addr(Address addr) override;
 #ifdef USE_DYNARMIC
     ExclusiveMonitorPtr get_exlusive_monitor() override;
+    SharedJitCachePtr get_shared_jit_cache() override;
 #endif
 
 private:
     CallImportFunc call_import;
+    CallHleImportFunc call_hle_import;
     KernelState *kernel;
     MemState *mem;
 };
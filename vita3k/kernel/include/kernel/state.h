@@ -61,6 +61,7 @@ typedef std::map<SceUID, ThreadPtr> ThreadPtrs;
 typedef std::map<SceUID, SceKernelModuleInfoPtr> SceKernelModuleInfoPtrs;
 typedef std::map<SceUID, CallbackPtr> CallbackPtrs;
 typedef unordered_map_fast<uint32_t, Address> ExportNids;
+typedef std::unordered_multimap<uint32_t, Address> HleImportStubs;
 
 typedef std::map<Address, uint32_t> NotFoundVars;
 typedef std::unique_ptr<CPUProtocol> CPUProtocolPtr;
@@ -128,16 +129,20 @@ struct KernelState {
     LoadedSysmodules loaded_sysmodules;
     LoadedInternalSysmodules loaded_internal_sysmodules;
     ExportNids export_nids;
+    HleImportStubs hle_import_stubs; // stubs bound to an HLE function, by NID
     std::mutex export_nids_mutex;
+    std::atomic<uint64_t> hle_call_count = 0;
     VarLateBindingInfos late_binding_infos;
     ModuleUidByNid module_uid_by_nid;
 
     bool cpu_opt;
+    bool cpu_shared_jit = false;
     CPUBackend cpu_backend;
     CorenumAllocator corenum_allocator;
     CPUProtocolPtr cpu_protocol;
 #ifdef USE_DYNARMIC
     ExclusiveMonitorPtr exclusive_monitor;
+    SharedJitCachePtr shared_jit_cache = nullptr;
 #endif
 
     ObjectStore obj_store;
@@ -152,7 +157,7 @@ struct KernelState {
         return next_uid++;
     }
 
-    bool init(MemState &mem, CallImportFunc call_import, CPUBackend cpu_backend, bool cpu_opt);
+    bool init(MemState &mem, CallImportFunc call_import, CallHleImportFunc call_hle_import, CPUBackend cpu_backend, bool cpu_opt);
     void load_process_param(MemState &mem, Ptr<uint32_t> ptr);
     ThreadStatePtr create_thread(MemState &mem, const char *name, Ptr<const void> entry_point = Ptr<const void>(0));
     ThreadStatePtr create_thread(MemState &mem, const char *name, Ptr<const void> entry_point, int init_priority, SceInt32 affinity_mask, int stack_size, const SceKernelThreadOptParam *option);
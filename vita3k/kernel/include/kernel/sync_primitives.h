@@ -231,10 +231,23 @@ SceUID mutex_create(SceUID *uid_out, KernelState &kernel, MemState &mem, const c
 SceUID mutex_find(KernelState &kernel, const char *export_name, const char *pName);
 int mutex_lock(KernelState &kernel, MemState &mem, const char *export_name, SceUID thread_id, SceUID mutexid, int lock_count, unsigned int *timeout, SyncWeight weight);
 int mutex_try_lock(KernelState &kernel, MemState &mem, const char *export_name, SceUID thread_id, SceUID mutexid, int lock_count, SyncWeight weight);
-int mutex_unlock(KernelState &kernel, const char *export_name, SceUID thread_id, SceUID mutexid, int unlock_count, SyncWeight weight);
+int mutex_unlock(KernelState &kernel, MemState &mem, const char *export_name, SceUID thread_id, SceUID mutexid, int unlock_count, SyncWeight weight);
 int mutex_delete(KernelState &kernel, const char *export_name, SceUID thread_id, SceUID mutexid, SyncWeight weight);
 MutexPtr mutex_get(KernelState &kernel, const char *export_name, SceUID thread_id, SceUID mutexid, SyncWeight weight);
 
+// The owner word of a lightweight mutex workarea holds the owning thread id, or 0 when free.
+// LW_MUTEX_CONTENDED is set while threads are (or may be) sleeping on the kernel object,
+// which forces the fast paths of the owner and of other threads back into the kernel.
+constexpr uint32_t LW_MUTEX_CONTENDED = 0x80000000;
+
+// Lightweight mutex user space fast path, operating on the workarea only.
+// Returns false when the kernel object has to be involved (contention or error).
+bool lwmutex_lock_fast(SceKernelLwMutexWork *workarea, SceUID thread_id, int lock_count);
+bool lwmutex_unlock_fast(SceKernelLwMutexWork *workarea, SceUID thread_id, int unlock_count);
+// Called under the kernel object lock when a waiter gives up without being handed the mutex,
+// drops LW_MUTEX_CONTENDED once nobody sleeps on the kernel object anymore.
+void lwmutex_waiter_left(SceKernelLwMutexWork *workarea, bool has_waiters);
+
 // RWLock
 SceUID rwlock_create(KernelState &kernel, MemState &mem, const char *export_name, const char *name, SceUID thread_id, SceUInt32 attr);
 SceInt32 rwlock_lock(KernelState &kernel, MemState &mem, const char *export_name, SceUID thread_id, SceUID lock_id, uint32_t *timeout, bool is_write);
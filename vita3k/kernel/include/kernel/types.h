@@ -646,7 +646,7 @@ struct SceKernelLMOption {
     SceSize size;
 };
 
-// We only use workarea for uid
+// owner, lockCount and attr are used by the user space fast path, uid links to the kernel object
 struct SceKernelLwMutexWork {
     std::uint32_t owner;
     std::uint32_t unknown0;
@@ -19,8 +19,9 @@
 #include <kernel/state.h>
 #include <util/lock_and_find.h>
 
-CPUProtocol::CPUProtocol(KernelState &kernel, MemState &mem, const CallImportFunc &func)
+CPUProtocol::CPUProtocol(KernelState &kernel, MemState &mem, const CallImportFunc &func, const CallHleImportFunc &hle_func)
     : call_import(func)
+    , call_hle_import(hle_func)
     , kernel(&kernel)
     , mem(&mem) {
 }
@@ -48,11 +49,16 @@ void CPUProtocol::call_svc(CPUState &cpu, uint32_t svc, Address pc, ThreadState
         return;
     }
 
-    // This is usual service call
-    uint32_t nid = *Ptr<uint32_t>(pc + 4).get(*mem);
-    // TODO: just supply ThreadStatePtr to call_import
-    // the only benefit of using thread_id instead--namely less locking-- has been gone for long
-    call_import(cpu, nid, thread.id);
+    if (svc & HLE_IMPORT_SVC_FLAG) {
+        // HLE import bound at load time, the svc immediate is the index of the function
+        call_hle_import(cpu, svc & HLE_IMPORT_SVC_INDEX_MASK, thread.id);
+    } else {
+        // This is usual service call
+        uint32_t nid = *Ptr<uint32_t>(pc + 4).get(*mem);
+        // TODO: just supply ThreadStatePtr to call_import
+        // the only benefit of using thread_id instead--namely less locking-- has been gone for long
+        call_import(cpu, nid, thread.id);
+    }
 
 #if defined(USE_DYNARMIC)
     // ARM recommends clearing exclusive state inside interrupt handler
@@ -68,4 +74,8 @@ Address CPUProtocol::get_watch_memory_addr(Address addr) {
 ExclusiveMonitorPtr CPUProtocol::get_exlusive_monitor() {
     return kernel->exclusive_monitor;
 }
+
+SharedJitCachePtr CPUProtocol::get_shared_jit_cache() {
+    return kernel->shared_jit_cache;
+}
 #endif
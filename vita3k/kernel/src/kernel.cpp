@@ -87,16 +87,24 @@ KernelState::KernelState()
     : debugger(*this) {
 }
 
-bool KernelState::init(MemState &mem, CallImportFunc call_import, CPUBackend cpu_backend, bool cpu_opt) {
+bool KernelState::init(MemState &mem, CallImportFunc call_import, CallHleImportFunc call_hle_import, CPUBackend cpu_backend, bool cpu_opt) {
     constexpr std::size_t MAX_CORE_COUNT = 150;
+    // shared jit instances get their own processor ids after the per-thread ones
+    constexpr std::size_t MAX_SHARED_JIT_COUNT = 32;
 
     corenum_allocator.set_max_core_count(MAX_CORE_COUNT);
 #ifdef USE_DYNARMIC
-    exclusive_monitor = new_exclusive_monitor(MAX_CORE_COUNT);
+    exclusive_monitor = new_exclusive_monitor(MAX_CORE_COUNT + MAX_SHARED_JIT_COUNT);
+    if (shared_jit_cache) {
+        free_shared_jit_cache(shared_jit_cache);
+        shared_jit_cache = nullptr;
+    }
+    if (cpu_backend == CPUBackend::Dynarmic && cpu_shared_jit)
+        shared_jit_cache = new_shared_jit_cache(mem, exclusive_monitor, cpu_opt, MAX_CORE_COUNT, MAX_SHARED_JIT_COUNT);
 #endif
     start_tick = rtc_get_ticks(rtc_base_ticks());
     base_tick = { rtc_base_ticks() };
-    cpu_protocol = std::make_unique<CPUProtocol>(*this, mem, call_import);
+    cpu_protocol = std::make_unique<CPUProtocol>(*this, mem, call_import, call_hle_import);
     this->cpu_backend = cpu_backend;
     this->cpu_opt = cpu_opt;
 
@@ -127,6 +135,10 @@ void KernelState::set_memory_watch(bool enabled) {
 }
 
 void KernelState::invalidate_jit_cache(Address start, size_t length) {
+#ifdef USE_DYNARMIC
+    if (shared_jit_cache)
+        invalidate_shared_jit_cache(shared_jit_cache, start, length);
+#endif
     std::lock_guard<std::mutex> lock(mutex);
     for (auto thread : threads) {
         ::invalidate_jit_cache(*thread.second->cpu, start, length);
@@ -137,7 +137,14 @@ static bool load_func_imports(const uint32_t *nids, const Ptr<uint32_t> *entries
         */
 
         if (export_address == kernel.export_nids.end()) {
-            stub[0] = 0xef000000; // svc #0 - Call our interrupt hook.
+            const uint32_t index = import_index(nid);
+            if (index <= HLE_IMPORT_SVC_INDEX_MASK) {
+                stub[0] = 0xef000000 | HLE_IMPORT_SVC_FLAG | index; // svc #index - Call our HLE function directly.
+                const std::lock_guard<std::mutex> guard(kernel.export_nids_mutex);
+                kernel.hle_import_stubs.emplace(nid, entry.address());
+            } else {
+                stub[0] = 0xef000000; // svc #0 - Call our interrupt hook.
+            }
             stub[1] = 0xe1a0f00e; // mov pc, lr - Return to the caller.
             stub[2] = nid; // Our interrupt hook will read this.
         } else {
@@ -221,7 +228,7 @@ static bool load_imports(const sce_module_info_raw &module, Ptr<const void> segm
     return true;
 }
 
-static bool load_func_exports(SceKernelModuleInfo *kernel_module_info, const uint32_t *nids, const Ptr<uint32_t> *entries, size_t count, KernelState &kernel) {
+static bool load_func_exports(SceKernelModuleInfo *kernel_module_info, const uint32_t *nids, const Ptr<uint32_t> *entries, size_t count, KernelState &kernel, MemState &mem) {
     for (size_t i = 0; i < count; ++i) {
         const uint32_t nid = nids[i];
         const Ptr<uint32_t> entry = entries[i];
@@ -240,10 +247,22 @@ static bool load_func_exports(SceKernelModuleInfo *kernel_module_info, const uin
             continue;
         }
 
+        std::vector<Address> rebound_stubs;
         {
             const std::lock_guard<std::mutex> guard(kernel.export_nids_mutex);
             kernel.export_nids.emplace(nid, entry.address());
+
+            // stubs already bound to our HLE implementation must now go to the LLE export,
+            // give them back the svc #0 which resolves the export and patches the stub on the next call
+            const auto range = kernel.hle_import_stubs.equal_range(nid);
+            for (auto it = range.first; it != range.second; ++it) {
+                *Ptr<uint32_t>(it->second).get(mem) = 0xef000000; // svc #0
+                rebound_stubs.push_back(it->second);
+            }
+            kernel.hle_import_stubs.erase(range.first, range.second);
         }
+        for (const Address stub : rebound_stubs)
+            kernel.invalidate_jit_cache(stub, 4);
 
         if (kernel.debugger.log_exports) {
             const char *const name = import_name(nid);
@@ -300,12 +319,11 @@ static bool load_var_exports(const uint32_t *nids, const Ptr<uint32_t> *entries,
                     auto &late_binding_info_v = i->second;
                     if (late_binding_info_v.size > 0) {
                         if (last_module_nid != late_binding_info_v.module_nid) {
-                            // TODO: uncomment when invalidate_jit_cache will be thread safe
-                            /* if (!seg.empty()) {
+                            if (!seg.empty()) {
                                 for (const auto &[key, value] : seg) {
                                     kernel.invalidate_jit_cache(value.addr, value.size);
                                 }
-                            }*/
+                            }
                             seg.clear();
                             const auto module_info = kernel.loaded_modules[kernel.module_uid_by_nid[late_binding_info_v.module_nid]];
                             if (!module_info) {
@@ -336,14 +354,11 @@ static bool load_var_exports(const uint32_t *nids, const Ptr<uint32_t> *entries,
             }
         }
     }
-    // TODO: uncomment when invalidate_jit_cache will be thread safe
-    /*
     if (!seg.empty()) {
         for (const auto &[key, value] : seg) {
             kernel.invalidate_jit_cache(value.addr, value.size);
         }
     }
-    */
     return true;
 }
 
@@ -361,7 +376,7 @@ static bool load_exports(SceKernelModuleInfo *kernel_module_info, const sce_modu
 
         const uint32_t *const nids = Ptr<const uint32_t>(exports->nid_table).get(mem);
         const Ptr<uint32_t> *const entries = Ptr<Ptr<uint32_t>>(exports->entry_table).get(mem);
-        if (!load_func_exports(kernel_module_info, nids, entries, exports->num_syms_funcs, kernel)) {
+        if (!load_func_exports(kernel_module_info, nids, entries, exports->num_syms_funcs, kernel, mem)) {
             return false;
         }
         const auto var_count = exports->num_syms_vars;
@@ -23,6 +23,8 @@
 #include <util/lock_and_find.h>
 #include <util/log.h>
 
+#include <atomic>
+
 static constexpr bool LOG_SYNC_PRIMITIVES = false;
 
 // ***********
@@ -538,6 +540,63 @@ SceInt32 timer_stop(KernelState &kernel, const char *export_name, SceUID thread_
 // * Mutex *
 // *********
 
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) && std::atomic<uint32_t>::is_always_lock_free);
+
+inline std::atomic<uint32_t> &lwmutex_owner(SceKernelLwMutexWork *workarea) {
+    return *reinterpret_cast<std::atomic<uint32_t> *>(&workarea->owner);
+}
+
+bool lwmutex_lock_fast(SceKernelLwMutexWork *workarea, SceUID thread_id, int lock_count) {
+    if (lock_count <= 0)
+        return false;
+
+    auto &owner = lwmutex_owner(workarea);
+    uint32_t expected = 0;
+    if (owner.compare_exchange_strong(expected, static_cast<uint32_t>(thread_id), std::memory_order_acquire)) {
+        workarea->lockCount = lock_count;
+        return true;
+    }
+
+    // Only the owner writes lockCount, so a recursive lock needs no atomic operation
+    if ((expected == static_cast<uint32_t>(thread_id)) && (workarea->attr & SCE_KERNEL_MUTEX_ATTR_RECURSIVE)) {
+        workarea->lockCount += lock_count;
+        return true;
+    }
+
+    return false;
+}
+
+bool lwmutex_unlock_fast(SceKernelLwMutexWork *workarea, SceUID thread_id, int unlock_count) {
+    auto &owner = lwmutex_owner(workarea);
+    if (owner.load(std::memory_order_relaxed) != static_cast<uint32_t>(thread_id))
+        return false;
+
+    const uint32_t count = workarea->lockCount;
+    if ((unlock_count <= 0) || (static_cast<uint32_t>(unlock_count) > count))
+        return false;
+
+    if (static_cast<uint32_t>(unlock_count) < count) {
+        workarea->lockCount = count - unlock_count;
+        return true;
+    }
+
+    // Clear the count before publishing the release, a new owner writes its own count right after
+    workarea->lockCount = 0;
+    uint32_t expected = static_cast<uint32_t>(thread_id);
+    if (owner.compare_exchange_strong(expected, 0, std::memory_order_release))
+        return true;
+
+    // A waiter flagged the word in the meantime, the kernel has to hand the mutex over
+    workarea->lockCount = count;
+    return false;
+}
+
+void lwmutex_waiter_left(SceKernelLwMutexWork *workarea, bool has_waiters) {
+    // Otherwise the flag would send every later fast path into the kernel for nothing
+    if (!has_waiters)
+        lwmutex_owner(workarea).fetch_and(~LW_MUTEX_CONTENDED, std::memory_order_relaxed);
+}
+
 SceUID mutex_create(SceUID *uid_out, KernelState &kernel, MemState &mem, const char *export_name, const char *mutex_name, SceUID thread_id, SceUInt attr, int init_count, Ptr<SceKernelLwMutexWork> workarea, SyncWeight weight) {
     if ((strlen(mutex_name) > 31) && ((attr & 0x80) == 0x80)) {
         return RET_ERROR(SCE_KERNEL_ERROR_UID_NAME_TOO_LONG);
@@ -571,8 +630,7 @@ SceUID mutex_create(SceUID *uid_out, KernelState &kernel, MemState &mem, const c
     if (weight == SyncWeight::Light) {
         SceKernelLwMutexWork *workarea_mem = workarea.get(mem);
         workarea_mem->lockCount = init_count;
-        if (workarea_mem->lockCount)
-            workarea_mem->owner = thread_id;
+        workarea_mem->owner = init_count ? thread_id : 0;
         workarea_mem->attr = attr;
     }
 
@@ -611,6 +669,66 @@ SceUID mutex_find(KernelState &kernel, const char *export_name, const char *pNam
     return RET_ERROR(SCE_KERNEL_ERROR_UID_CANNOT_FIND_BY_NAME);
 }
 
+// Slow path of a lightweight mutex, the workarea stays the source of truth for owner and count
+inline int lwmutex_lock_impl(KernelState &kernel, MemState &mem, const char *export_name, SceUID thread_id, int lock_count, MutexPtr &mutex, SceUInt *timeout, bool only_try) {
+    const ThreadStatePtr thread = lock_and_find(thread_id, kernel.threads, kernel.mutex);
+
+    std::unique_lock<std::mutex> mutex_lock(mutex->mutex);
+
+    SceKernelLwMutexWork *workarea = mutex->workarea.get(mem);
+    auto &owner = lwmutex_owner(workarea);
+    uint32_t word = owner.load(std::memory_order_relaxed);
+    while (true) {
+        // Not owned, take ownership!
+        if (word == 0) {
+            if (!owner.compare_exchange_weak(word, static_cast<uint32_t>(thread_id), std::memory_order_acquire))
+                continue;
+
+            workarea->lockCount = lock_count;
+            mutex->lock_count = lock_count;
+            mutex->owner = thread;
+            return SCE_KERNEL_OK;
+        }
+
+        // Owned by ourselves
+        if ((word & ~LW_MUTEX_CONTENDED) == static_cast<uint32_t>(thread_id)) {
+            if (mutex->attr & SCE_KERNEL_MUTEX_ATTR_RECURSIVE) {
+                workarea->lockCount += lock_count;
+                mutex->lock_count = workarea->lockCount;
+                return SCE_KERNEL_OK;
+            }
+
+            return RET_ERROR(SCE_KERNEL_ERROR_LW_MUTEX_RECURSIVE);
+        }
+
+        // Owned by someone else
+        if (only_try)
+            return RET_ERROR(SCE_KERNEL_ERROR_LW_MUTEX_FAILED_TO_OWN);
+
+        // Flag the word so the owner releases through the kernel and wakes us up
+        if ((word & LW_MUTEX_CONTENDED) || owner.compare_exchange_weak(word, word | LW_MUTEX_CONTENDED, std::memory_order_relaxed))
+            break;
+    }
+
+    // Sleep thread!
+    std::unique_lock<std::mutex> thread_lock(thread->mutex);
+    thread->update_status(ThreadStatus::wait, ThreadStatus::run);
+
+    WaitingThreadData data;
+    data.thread = thread;
+    data.lock_count = lock_count;
+    data.priority = thread->priority;
+
+    const auto data_it = mutex->waiting_threads->push(data);
+    thread_lock.unlock();
+
+    // On success the unlocking thread has already handed us the owner word and the count
+    const int ret = handle_timeout(thread, thread_lock, mutex_lock, mutex->waiting_threads, data, data_it, export_name, timeout);
+    if (ret < 0)
+        lwmutex_waiter_left(workarea, !mutex->waiting_threads->empty());
+    return ret;
+}
+
 inline int mutex_lock_impl(KernelState &kernel, MemState &mem, const char *export_name, SceUID thread_id, int lock_count, MutexPtr &mutex, SyncWeight weight, SceUInt *timeout, bool only_try) {
     if (LOG_SYNC_PRIMITIVES) {
         LOG_DEBUG("{}: uid: {} thread_id: {} name: \"{}\" attr: {} lock_count: {} timeout: {} waiting_threads: {}",
@@ -618,6 +736,9 @@ inline int mutex_lock_impl(KernelState &kernel, MemState &mem, const char *expor
             mutex->waiting_threads->size());
     }
 
+    if (weight == SyncWeight::Light)
+        return lwmutex_lock_impl(kernel, mem, export_name, thread_id, lock_count, mutex, timeout, only_try);
+
     const ThreadStatePtr thread = lock_and_find(thread_id, kernel.threads, kernel.mutex);
 
     std::unique_lock<std::mutex> mutex_lock(mutex->mutex);
@@ -630,25 +751,16 @@ inline int mutex_lock_impl(KernelState &kernel, MemState &mem, const char *expor
         if (mutex->owner == thread) {
             if (is_recursive) {
                 mutex->lock_count += lock_count;
-                if (weight == SyncWeight::Light)
-                    mutex->workarea.get(mem)->lockCount += lock_count;
-
                 return SCE_KERNEL_OK;
             }
-            if (weight == SyncWeight::Light)
-                return RET_ERROR(SCE_KERNEL_ERROR_LW_MUTEX_RECURSIVE);
 
             return RET_ERROR(SCE_KERNEL_ERROR_MUTEX_RECURSIVE);
         }
         // Owned by someone else
 
         // Don't sleep if only_try is set
-        if (only_try) {
-            if (weight == SyncWeight::Light)
-                return RET_ERROR(SCE_KERNEL_ERROR_LW_MUTEX_FAILED_TO_OWN);
-
+        if (only_try)
             return RET_ERROR(SCE_KERNEL_ERROR_MUTEX_FAILED_TO_OWN);
-        }
 
         // Sleep thread!
         std::unique_lock<std::mutex> thread_lock(thread->mutex);
@@ -662,16 +774,7 @@ inline int mutex_lock_impl(KernelState &kernel, MemState &mem, const char *expor
         const auto data_it = mutex->waiting_threads->push(data);
         thread_lock.unlock();
 
-        int res = handle_timeout(thread, thread_lock, mutex_lock, mutex->waiting_threads, data, data_it, export_name, timeout);
-
-        if (weight == SyncWeight::Light) {
-            mutex->workarea.get(mem)->lockCount = mutex->lock_count;
-            if (mutex->owner == thread) {
-                mutex->workarea.get(mem)->owner = thread_id;
-            }
-        }
-
-        return res;
+        return handle_timeout(thread, thread_lock, mutex_lock, mutex->waiting_threads, data, data_it, export_name, timeout);
     }
     // Not owned
     // Take ownership!
@@ -679,13 +782,6 @@ inline int mutex_lock_impl(KernelState &kernel, MemState &mem, const char *expor
     mutex->lock_count += lock_count;
     mutex->owner = thread;
 
-    if (weight == SyncWeight::Light) {
-        mutex->workarea.get(mem)->lockCount = mutex->lock_count;
-        if (mutex->owner == thread) {
-            mutex->workarea.get(mem)->owner = thread_id;
-        }
-    }
-
     return SCE_KERNEL_OK;
 }
 
@@ -709,7 +805,48 @@ int mutex_try_lock(KernelState &kernel, MemState &mem, const char *export_name,
     return mutex_lock_impl(kernel, mem, export_name, thread_id, lock_count, mutex, weight, nullptr, true);
 }
 
-inline int mutex_unlock_impl(KernelState &kernel, const char *export_name, SceUID thread_id, int unlock_count, MutexPtr &mutex) {
+inline int lwmutex_unlock_impl(MemState &mem, const char *export_name, SceUID thread_id, int unlock_count, MutexPtr &mutex) {
+    const std::lock_guard<std::mutex> mutex_lock(mutex->mutex);
+
+    SceKernelLwMutexWork *workarea = mutex->workarea.get(mem);
+    auto &owner = lwmutex_owner(workarea);
+    if ((owner.load(std::memory_order_relaxed) & ~LW_MUTEX_CONTENDED) != static_cast<uint32_t>(thread_id))
+        return SCE_KERNEL_OK;
+
+    if (static_cast<uint32_t>(unlock_count) > workarea->lockCount)
+        return RET_ERROR(SCE_KERNEL_ERROR_LW_MUTEX_UNLOCK_UDF);
+
+    workarea->lockCount -= unlock_count;
+    mutex->lock_count = workarea->lockCount;
+    if (workarea->lockCount > 0)
+        return SCE_KERNEL_OK;
+
+    if (mutex->waiting_threads->empty()) {
+        mutex->owner = nullptr;
+        owner.store(0, std::memory_order_release);
+        return SCE_KERNEL_OK;
+    }
+
+    // Hand the mutex over to the first waiting thread, keeping the word flagged while others still wait
+    const auto waiting_thread_data = *mutex->waiting_threads->begin();
+    const auto waiting_thread = waiting_thread_data.thread;
+
+    const std::lock_guard<std::mutex> waiting_thread_lock(waiting_thread->mutex);
+    waiting_thread->update_status(ThreadStatus::run, ThreadStatus::wait);
+
+    mutex->waiting_threads->pop();
+    workarea->lockCount = waiting_thread_data.lock_count;
+    mutex->lock_count = waiting_thread_data.lock_count;
+    mutex->owner = waiting_thread;
+    owner.store(static_cast<uint32_t>(waiting_thread->id) | (mutex->waiting_threads->empty() ? 0 : LW_MUTEX_CONTENDED), std::memory_order_release);
+
+    return SCE_KERNEL_OK;
+}
+
+inline int mutex_unlock_impl(KernelState &kernel, MemState &mem, const char *export_name, SceUID thread_id, int unlock_count, MutexPtr &mutex, SyncWeight weight) {
+    if (weight == SyncWeight::Light)
+        return lwmutex_unlock_impl(mem, export_name, thread_id, unlock_count, mutex);
+
     const ThreadStatePtr current_thread = lock_and_find(thread_id, kernel.threads, kernel.mutex);
 
     const std::lock_guard<std::mutex> mutex_lock(mutex->mutex);
@@ -742,7 +879,7 @@ inline int mutex_unlock_impl(KernelState &kernel, const char *export_name, SceUI
     return SCE_KERNEL_OK;
 }
 
-int mutex_unlock(KernelState &kernel, const char *export_name, SceUID thread_id, SceUID mutexid, int unlock_count, SyncWeight weight) {
+int mutex_unlock(KernelState &kernel, MemState &mem, const char *export_name, SceUID thread_id, SceUID mutexid, int unlock_count, SyncWeight weight) {
     assert(mutexid >= 0);
 
     MutexPtr mutex;
@@ -755,7 +892,7 @@ int mutex_unlock(KernelState &kernel, const char *export_name, SceUID thread_id,
             mutex->waiting_threads->size());
     }
 
-    return mutex_unlock_impl(kernel, export_name, thread_id, unlock_count, mutex);
+    return mutex_unlock_impl(kernel, mem, export_name, thread_id, unlock_count, mutex, weight);
 }
 
 int mutex_delete(KernelState &kernel, const char *export_name, SceUID thread_id, SceUID mutexid, SyncWeight weight) {
@@ -1240,7 +1377,7 @@ int condvar_wait(KernelState &kernel, MemState &mem, const char *export_name, Sc
 
     std::unique_lock<std::mutex> condition_variable_lock(condvar->mutex);
 
-    if (auto error = mutex_unlock_impl(kernel, export_name, thread_id, 1, condvar->associated_mutex))
+    if (auto error = mutex_unlock_impl(kernel, mem, export_name, thread_id, 1, condvar->associated_mutex, weight))
         return error;
 
     std::unique_lock<std::mutex> thread_lock(thread->mutex);
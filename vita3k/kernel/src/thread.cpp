@@ -259,7 +259,7 @@ bool ThreadState::run_loop() {
 
                 // handle svc call if this was what stopped the cpu
                 if (cpu->svc_called) {
-                    cpu->protocol->call_svc(*cpu, cpu->svc_called, read_pc(*cpu), *this);
+                    cpu->protocol->call_svc(*cpu, cpu->svc, read_pc(*cpu), *this);
                 }
             } while (to_do == ThreadToDo::run && res == 0 && call_level == run_level && !hit_breakpoint(*cpu));
 
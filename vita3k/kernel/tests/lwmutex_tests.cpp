@@ -0,0 +1,62 @@
+// Vita3K emulator project
+// Copyright (C) 2024 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <kernel/sync_primitives.h>
+#include <kernel/types.h>
+
+#include <gtest/gtest.h>
+
+static constexpr SceUID OWNER_ID = 0x40010003;
+static constexpr SceUID WAITER_ID = 0x40010005;
+
+TEST(lwmutex, fast_path_round_trip) {
+    SceKernelLwMutexWork workarea{};
+    ASSERT_TRUE(lwmutex_lock_fast(&workarea, OWNER_ID, 1));
+    ASSERT_EQ(workarea.owner, static_cast<uint32_t>(OWNER_ID));
+    ASSERT_FALSE(lwmutex_lock_fast(&workarea, WAITER_ID, 1));
+    ASSERT_TRUE(lwmutex_unlock_fast(&workarea, OWNER_ID, 1));
+    ASSERT_EQ(workarea.owner, 0u);
+    ASSERT_EQ(workarea.lockCount, 0u);
+}
+
+TEST(lwmutex, contended_word_goes_through_kernel) {
+    SceKernelLwMutexWork workarea{};
+    ASSERT_TRUE(lwmutex_lock_fast(&workarea, OWNER_ID, 1));
+    // a waiter flags the word before sleeping on the kernel object
+    workarea.owner |= LW_MUTEX_CONTENDED;
+    ASSERT_FALSE(lwmutex_unlock_fast(&workarea, OWNER_ID, 1));
+    ASSERT_EQ(workarea.lockCount, 1u);
+
+    // another waiter is still sleeping, the owner has to keep going through the kernel
+    lwmutex_waiter_left(&workarea, true);
+    ASSERT_FALSE(lwmutex_unlock_fast(&workarea, OWNER_ID, 1));
+}
+
+TEST(lwmutex, last_waiter_timeout_restores_fast_path) {
+    SceKernelLwMutexWork workarea{};
+    ASSERT_TRUE(lwmutex_lock_fast(&workarea, OWNER_ID, 1));
+    workarea.owner |= LW_MUTEX_CONTENDED;
+
+    // the only waiter timed out, nobody is left to hand the mutex to
+    lwmutex_waiter_left(&workarea, false);
+    ASSERT_EQ(workarea.owner, static_cast<uint32_t>(OWNER_ID));
+    ASSERT_TRUE(lwmutex_unlock_fast(&workarea, OWNER_ID, 1));
+    ASSERT_EQ(workarea.owner, 0u);
+
+    ASSERT_TRUE(lwmutex_lock_fast(&workarea, WAITER_ID, 1));
+    ASSERT_EQ(workarea.owner, static_cast<uint32_t>(WAITER_ID));
+}
@@ -445,7 +445,11 @@ struct LangState {
     std::map<std::string, std::string> performance_overlay = {
         { "avg", "Avg" },
         { "min", "Min" },
-        { "max", "Max" }
+        { "max", "Max" },
+        { "hle_calls", "HLE calls/s" },
+        { "uniforms", "Uniforms" },
+        { "descriptor_writes", "Descriptor writes" },
+        { "merged_draws", "Merged draws" }
     };
     struct Settings {
         std::map<std::string, std::string> main = { { "title", "Settings" } };
@@ -550,6 +554,8 @@ struct LangState {
             { "surface_sync_description", "Speed hack, check the box to disable surface syncing between CPU and GPU.\nSurface syncing is needed by a few games.\nGives a big performance boost if disabled (in particular when upscaling is on)." },
             { "async_pipeline_compilation", "Asynchronous Pipeline Compilation" },
             { "async_pipeline_compilation_description", "Allow pipelines to be compiled concurrently on multiple concurrent threads.\nThis decreases pipeline compilation stutter at the cost of temporary graphical glitches." },
+            { "async_texture_decode", "Asynchronous Texture Decoding" },
+            { "async_texture_decode_description", "Convert textures to a format the GPU supports on multiple worker threads.\nThis decreases stutter when many textures are loaded at once, a texture is shown black or with its previous content until it is ready." },
             { "nearest", "Nearest" },
             { "bilinear", "Bilinear" },
             { "bicubic", "Bicubic" },
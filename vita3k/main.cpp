@@ -497,6 +497,7 @@ int main(int argc, char *argv[]) {
             gui::draw_end(gui, emuenv.window.get());
             emuenv.renderer->swap_window(emuenv.window.get());
         }
+        emuenv.renderer->prewarm_pipelines();
     }
     {
         const auto err = run_app(emuenv, main_module_id);
@@ -580,6 +581,9 @@ int main(int argc, char *argv[]) {
 #endif
 
     emuenv.renderer->preclose_action();
+    const SPSCQueueStats queue_stats = emuenv.renderer->command_buffer_queue.stats();
+    LOG_INFO("Command list queue: max occupancy {}, GXM thread stalled {} ms, render thread stalled {} ms",
+        queue_stats.max_occupancy, queue_stats.producer_stall_us / 1000, queue_stats.consumer_stall_us / 1000);
     app::destroy(emuenv, gui.imgui_state.get());
 
     if (emuenv.load_exec)
@@ -21,12 +21,28 @@
 #include <mutex>
 #include <vector>
 
+/**
+ * \brief Bitmap allocator, a set bit in words means the slot is free.
+ *
+ * The words are summarized by groups of WORDS_PER_GROUP words so that allocations and
+ * counts can skip the parts of the bitmap which can't satisfy them. The summaries are
+ * conservative: they stay valid if bits of words are cleared without going through
+ * the allocator, but not if bits are set.
+ */
 struct BitmapAllocator {
+    static constexpr std::uint32_t WORDS_PER_GROUP = 64;
+    static constexpr std::uint32_t BITS_PER_GROUP = WORDS_PER_GROUP * 32;
+
     std::vector<std::uint32_t> words;
+    // bit i of group_free_words[g] is set if words[g * WORDS_PER_GROUP + i] may have free bits
+    std::vector<std::uint64_t> group_free_words;
+    // upper bound of the longest free run contained in each group
+    std::vector<std::uint16_t> group_max_run;
     std::size_t max_offset;
 
 protected:
     int force_fill(const std::uint32_t offset, const int size, const bool or_mode = false);
+    void update_summary(const std::uint32_t first_word, const std::uint32_t last_word);
 
 public:
     BitmapAllocator() = default;
@@ -44,6 +44,14 @@ bool add_protect(MemState &state, Address addr, const uint32_t size, const MemPe
 void add_external_mapping(MemState &mem, Address addr, uint32_t size, uint8_t *addr_ptr);
 void remove_external_mapping(MemState &mem, uint8_t *addr_ptr, uint32_t size);
 bool is_protecting(MemState &state, Address addr, MemPerm *perm = nullptr);
+
+// Write tracking, polled alternative to add_protect callbacks.
+// Write protects the pages of the range which are not tracked yet, using one protection call per contiguous run.
+// The first write to a tracked page records the current epoch for this page and only unprotects this page.
+// Returns the epoch to give to is_range_written.
+WriteEpoch track_writes(MemState &state, Address addr, uint32_t size);
+// Tells if one of the pages of the range was written to after the matching track_writes call
+bool is_range_written(const MemState &state, Address addr, uint32_t size, WriteEpoch since);
 bool is_valid_addr(const MemState &state, Address addr);
 bool is_valid_addr_range(const MemState &state, Address start, Address end);
 bool handle_access_violation(MemState &state, uint8_t *addr, bool write) noexcept;
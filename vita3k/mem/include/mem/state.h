@@ -21,6 +21,7 @@
 #include <mem/util.h>
 
 #include <array>
+#include <atomic>
 #include <map>
 #include <mutex>
 #include <set>
@@ -57,6 +58,15 @@ struct ProtectSegmentInfo {
 
 typedef std::map<Address, ProtectSegmentInfo, std::greater<Address>> ProtectSegmentTrees;
 
+// One entry per page for the whole address space
+struct WriteTrackingState {
+    // pages write protected by track_writes which have not been written to yet
+    std::unique_ptr<std::atomic<uint64_t>[]> armed;
+    // epoch of the last recorded write to each page
+    std::unique_ptr<std::atomic<WriteEpoch>[]> page_epochs;
+    std::atomic<WriteEpoch> epoch{ 1 };
+};
+
 struct MemExternalMapping {
     Address address;
     uint32_t size;
@@ -71,6 +81,7 @@ struct MemState {
     AllocPageTable alloc_table;
     BitmapAllocator allocator;
     ProtectSegmentTrees protect_tree;
+    WriteTrackingState write_tracking;
 
     PageNameMap page_name_map;
 
@@ -28,6 +28,8 @@ struct MemState;
 
 typedef uint32_t Address;
 typedef std::function<bool(Address, bool)> ProtectCallback;
+// Write tracking timestamp, see track_writes
+typedef uint32_t WriteEpoch;
 
 // Powers of 10
 constexpr size_t KB(size_t kb) {
@@ -17,9 +17,13 @@
 
 #include <mem/allocator.h>
 
+#include <algorithm>
+#include <bit>
+
 BitmapAllocator::BitmapAllocator(const std::size_t total_bits)
     : words((total_bits >> 5) + ((total_bits % 32 != 0) ? 1 : 0), 0xFFFFFFFF)
     , max_offset(total_bits) {
+    update_summary(0, static_cast<std::uint32_t>(words.size()) - 1);
 }
 
 void BitmapAllocator::set_maximum(const std::size_t total_bits) {
@@ -35,10 +39,69 @@ void BitmapAllocator::set_maximum(const std::size_t total_bits) {
     }
 
     max_offset = total_bits;
+    update_summary(0, static_cast<std::uint32_t>(words.size()) - 1);
 }
 
 void BitmapAllocator::reset() {
     words.clear();
+    group_free_words.clear();
+    group_max_run.clear();
+}
+
+// Calls on_run(offset, length) for each run of free bits in the word, the first bit of the word is its MSB.
+// Only the first limit bits of the word are looked at.
+template <typename F>
+static void for_each_free_run(const std::uint32_t value, const std::uint32_t limit, F on_run) {
+    std::uint32_t pos = 0;
+    while (pos < limit) {
+        const std::uint32_t shifted = value << pos;
+        const std::uint32_t ones = std::min<std::uint32_t>(std::countl_one(shifted), limit - pos);
+        if (ones > 0) {
+            on_run(pos, ones);
+            pos += ones;
+        } else {
+            // 32 if there is no free bit left
+            pos += std::countl_zero(shifted);
+        }
+    }
+}
+
+void BitmapAllocator::update_summary(const std::uint32_t first_word, const std::uint32_t last_word) {
+    if (words.empty()) {
+        return;
+    }
+
+    const std::size_t group_count = (words.size() + WORDS_PER_GROUP - 1) / WORDS_PER_GROUP;
+    group_free_words.resize(group_count, 0);
+    group_max_run.resize(group_count, 0);
+
+    const std::uint32_t last_group = std::min<std::uint32_t>(last_word, static_cast<std::uint32_t>(words.size()) - 1) / WORDS_PER_GROUP;
+    for (std::uint32_t group = first_word / WORDS_PER_GROUP; group <= last_group; group++) {
+        const std::uint32_t group_begin = group * WORDS_PER_GROUP;
+        const std::uint32_t group_end = std::min<std::uint32_t>(group_begin + WORDS_PER_GROUP, static_cast<std::uint32_t>(words.size()));
+
+        std::uint64_t free_words = 0;
+        std::uint32_t max_run = 0;
+        std::uint32_t run_end = 0;
+        std::uint32_t run_length = 0;
+        for (std::uint32_t w = group_begin; w < group_end; w++) {
+            const std::uint32_t limit = static_cast<std::uint32_t>(std::min<std::size_t>(32, max_offset - std::min<std::size_t>(max_offset, w * 32ULL)));
+            if (words[w] == 0 || limit == 0) {
+                continue;
+            }
+
+            free_words |= 1ULL << (w - group_begin);
+            for_each_free_run(words[w], limit, [&](const std::uint32_t pos, const std::uint32_t length) {
+                const std::uint32_t offset = w * 32 + pos;
+                run_length = (offset == run_end) ? run_length + length : length;
+                run_end = offset + length;
+                max_run = std::max(max_run, run_length);
+            });
+        }
+
+        group_free_words[group] = free_words;
+        group_max_run[group] = static_cast<std::uint16_t>(max_run);
+    }
 }
 
 int BitmapAllocator::force_fill(const std::uint32_t offset, const int size, const bool or_mode) {
@@ -58,6 +121,7 @@ int BitmapAllocator::force_fill(const std::uint32_t offset, const int size, cons
             *word = wval & (~mask);
         }
 
+        update_summary(offset >> 5, offset >> 5);
         return std::min<int>(size, static_cast<int>((words.size() << 5) - set_bit));
     }
 
@@ -85,6 +149,7 @@ int BitmapAllocator::force_fill(const std::uint32_t offset, const int size, cons
         }
     }
 
+    update_summary(offset >> 5, static_cast<std::uint32_t>(word - words.data()) - 1);
     return std::min<int>(size, static_cast<int>((words.size() << 5) - set_bit));
 }
 
@@ -101,79 +166,113 @@ int BitmapAllocator::allocate_from(const std::uint32_t start_offset, int &size,
         return -1;
     }
 
-    std::uint32_t *word = &words[0] + (start_offset >> 5);
-
-    // We have arrived at le word that still have free position (bit 1)
-    std::uint32_t *word_end = &words[words.size() - 1];
-
-    int bflmin = 0xFFFFFF;
-    int bofmin = -1;
-    std::uint32_t *wordmin = nullptr;
-
-    // Keep finding
-    while (word <= word_end) {
-        std::uint32_t wv = *word;
-
-        if (wv != 0) {
-            // Still have free stuff
-            int bflen = 0;
-            int boff = 0;
-            std::uint32_t *bword = nullptr;
-
-            int cursor = 31;
-
-            while (cursor >= 0) {
-                if (((wv >> cursor) & 1) == 1) {
-                    boff = cursor;
-                    bflen = 0;
-                    bword = word;
-
-                    while (cursor >= 0 && (((wv >> cursor) & 1) == 1)) {
-                        bflen++;
-                        cursor--;
-
-                        if (cursor < 0 && (word + 1 <= word_end)) {
-                            cursor = 31;
-                            word++;
-                            wv = *word;
-                        }
-                    }
-
-                    if (bflen >= size) {
-                        if (!best_fit) {
-                            // Force allocate and then return
-                            const int offset = static_cast<int>(31 - boff + ((bword - &words[0]) << 5));
-                            if ((static_cast<std::size_t>(offset) + size) <= max_offset) {
-                                size = force_fill(static_cast<const std::uint32_t>(offset), size, false);
-                                return offset;
-                            }
-                        } else {
-                            if (bflen < bflmin) {
-                                bflmin = bflen;
-                                bofmin = boff;
-                                wordmin = bword;
-                            }
-                        }
-                    }
+    const std::uint32_t word_count = static_cast<std::uint32_t>(std::min<std::size_t>(words.size(), (max_offset + 31) / 32));
+    const std::uint32_t wanted = static_cast<std::uint32_t>(std::max(size, 0));
+
+    // the free run being walked through
+    std::uint32_t run_offset = 0;
+    std::uint32_t run_length = 0;
+
+    int best_offset = -1;
+    std::uint32_t best_length = UINT32_MAX;
+    int found_offset = -1;
+
+    // returns true when the search is over
+    const auto end_run = [&]() {
+        if (run_length >= wanted && run_length < best_length) {
+            best_offset = static_cast<int>(run_offset);
+            best_length = run_length;
+        }
+        run_length = 0;
+        // a perfect fit can't be beaten
+        return best_length == wanted;
+    };
+
+    // The search starts at the beginning of the word containing start_offset
+    std::uint32_t w = start_offset >> 5;
+    while (w < word_count && found_offset < 0) {
+        if (run_length == 0 && w % WORDS_PER_GROUP == 0) {
+            const std::uint32_t group = w / WORDS_PER_GROUP;
+            const std::uint64_t free_words = group_free_words[group];
+            const std::uint32_t group_last_word = std::min(w + WORDS_PER_GROUP, word_count) - 1;
+
+            if (free_words == 0) {
+                // the group is full
+                w += WORDS_PER_GROUP;
+                continue;
+            }
+            if (group_max_run[group] < wanted) {
+                // the runs of the group are too short, only the one reaching the next group may fit
+                if ((words[group_last_word] & 1) == 0) {
+                    w += WORDS_PER_GROUP;
+                    continue;
+                }
+                std::uint32_t run_word = group_last_word;
+                while (run_word > w && words[run_word] == 0xFFFFFFFFU)
+                    run_word--;
+                w = run_word;
+            } else {
+                // skip the full words at the beginning of the group
+                w += std::countr_zero(free_words);
+            }
+        }
+
+        const std::uint32_t value = words[w];
+        if (value == 0) {
+            if (run_length > 0 && end_run())
+                break;
+            w++;
+            continue;
+        }
+
+        const std::uint32_t limit = static_cast<std::uint32_t>(std::min<std::size_t>(32, max_offset - w * 32ULL));
+        bool done = false;
+        for_each_free_run(value, limit, [&](const std::uint32_t pos, const std::uint32_t length) {
+            if (done) {
+                return;
+            }
+
+            const std::uint32_t offset = w * 32 + pos;
+            if (run_length > 0 && run_offset + run_length != offset) {
+                done = end_run();
+                if (done) {
+                    return;
                 }
+            }
+            if (run_length == 0) {
+                run_offset = offset;
+            }
+            run_length += length;
 
-                cursor--;
+            if (!best_fit && run_length >= wanted) {
+                found_offset = static_cast<int>(run_offset);
+                done = true;
             }
+        });
+        if (done && best_fit) {
+            break;
         }
 
-        word++;
+        // the run does not go on in the next word
+        if (limit < 32 || (value & 1) == 0) {
+            if (run_length > 0 && end_run())
+                break;
+        }
+
+        w++;
     }
 
-    if (best_fit && bofmin != -1) {
-        // Force allocate and then return
-        const int offset = static_cast<int>(31 - bofmin + ((wordmin - &words[0]) << 5));
-        if ((static_cast<std::size_t>(offset) + size) <= max_offset) {
-            size = force_fill(static_cast<std::uint32_t>(offset), size, false);
-            return offset;
-        }
+    if (found_offset < 0 && run_length > 0) {
+        end_run();
+    }
+
+    const int offset = best_fit ? best_offset : found_offset;
+    if (offset < 0) {
+        return -1;
     }
 
-    return -1;
+    size = force_fill(static_cast<std::uint32_t>(offset), size, false);
+    return offset;
 }
 
 int BitmapAllocator::allocate_at(const std::uint32_t start_offset, int size) {
@@ -185,12 +284,6 @@ int BitmapAllocator::allocate_at(const std::uint32_t start_offset, int size) {
     return 0;
 }
 
-static int number_of_set_bits(std::uint32_t i) {
-    i = i - ((i >> 1) & 0x55555555);
-    i = (i & 0x33333333) + ((i >> 2) & 0x33333333);
-    return (((i + (i >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
-}
-
 int BitmapAllocator::free_slot_count(const std::uint32_t offset, const std::uint32_t offset_end) const {
     if (offset >= offset_end) {
         return -1;
@@ -209,12 +302,18 @@ int BitmapAllocator::free_slot_count(const std::uint32_t offset, const std::uint
     std::uint32_t free_count = 0;
 
     while (start_bit < end_bit) {
+        if (start_bit % BITS_PER_GROUP == 0 && start_bit + BITS_PER_GROUP <= end_bit && group_free_words[start_bit / BITS_PER_GROUP] == 0) {
+            // the whole group is allocated
+            start_bit += BITS_PER_GROUP;
+            continue;
+        }
+
         const std::uint32_t next_end_bit = std::min<std::uint32_t>(((start_bit + 32) >> 5) << 5, end_bit);
 
         const int left_shift = start_bit & 31;
         const int right_shift = (31 - (next_end_bit - 1) & 31);
         std::uint32_t word_to_scan = words[start_bit >> 5] << left_shift >> right_shift >> left_shift;
-        free_count += number_of_set_bits(word_to_scan);
+        free_count += std::popcount(word_to_scan);
 
         start_bit = next_end_bit;
     }
@@ -105,6 +105,9 @@ bool init(MemState &state, const bool use_page_table) {
 
     state.allocator.set_maximum(table_length);
 
+    state.write_tracking.armed = std::make_unique<std::atomic<uint64_t>[]>((table_length + 63) / 64);
+    state.write_tracking.page_epochs = std::make_unique<std::atomic<WriteEpoch>[]>(table_length);
+
     const auto handler = [&state](uint8_t *addr, bool write) noexcept {
         return handle_access_violation(state, addr, write);
     };
@@ -160,6 +163,22 @@ bool is_valid_addr_range(const MemState &state, Address start, Address end) {
     return state.allocator.free_slot_count(start_page, end_page) == 0;
 }
 
+// Gives the pages back to the OS, they will read as zero once committed again
+static void decommit_pages(MemState &state, const uint32_t page_num, const uint32_t page_count) {
+    uint8_t *const memory = &state.memory[page_num * state.page_size];
+    const size_t size = static_cast<size_t>(page_count) * state.page_size;
+
+#ifdef WIN32
+    const BOOL ret = VirtualFree(memory, size, MEM_DECOMMIT);
+    LOG_CRITICAL_IF(!ret, "VirtualFree failed: {}", get_error_msg());
+#else
+    int ret = mprotect(memory, size, PROT_NONE);
+    LOG_CRITICAL_IF(ret == -1, "mprotect failed: {}", get_error_msg());
+    ret = madvise(memory, size, MADV_DONTNEED);
+    LOG_CRITICAL_IF(ret == -1, "madvise failed: {}", get_error_msg());
+#endif
+}
+
 static Address alloc_inner(MemState &state, uint32_t start_page, int page_count, const char *name, const bool force) {
     int page_num;
     if (force) {
@@ -178,6 +197,8 @@ static Address alloc_inner(MemState &state, uint32_t start_page, int page_count,
     uint8_t *const memory = &state.memory[addr];
 
     // Make memory chunk available to access
+    // Free pages are always decommitted, so there is no need to clear them: the OS
+    // hands out zero pages on first touch and untouched pages never become resident
 #ifdef WIN32
     const void *const ret = VirtualAlloc(memory, size, MEM_COMMIT, PAGE_READWRITE);
     LOG_CRITICAL_IF(!ret, "VirtualAlloc failed: {}", get_error_msg());
@@ -185,7 +206,6 @@ static Address alloc_inner(MemState &state, uint32_t start_page, int page_count,
     const int ret = mprotect(memory, size, PROT_READ | PROT_WRITE);
     LOG_CRITICAL_IF(ret == -1, "mprotect failed: {}", get_error_msg());
 #endif
-    std::memset(memory, 0, size);
 
     AllocMemPage &page = state.alloc_table[page_num];
     assert(!page.allocated);
@@ -215,6 +235,7 @@ Address alloc_aligned(MemState &state, uint32_t size, const char *name, unsigned
         AllocMemPage &align_page = state.alloc_table[align_page_num];
         const uint32_t remnant_front = align_page_num - page_num;
         state.allocator.free(page_num, remnant_front);
+        decommit_pages(state, page_num, remnant_front);
         page.allocated = 0;
         align_page.allocated = 1;
         align_page.size = page.size - remnant_front;
@@ -258,6 +279,26 @@ void protect_inner(MemState &state, Address addr, uint32_t size, const MemPerm p
 #endif
 }
 
+// Returns true if the page was armed, in which case the write is recorded
+static bool record_tracked_write(MemState &state, const uint32_t page) {
+    const uint64_t bit = 1ULL << (page % 64);
+    if (!(state.write_tracking.armed[page / 64].fetch_and(~bit, std::memory_order_acq_rel) & bit))
+        return false;
+
+    const WriteEpoch epoch = state.write_tracking.epoch.fetch_add(1, std::memory_order_acq_rel) + 1;
+    state.write_tracking.page_epochs[page].store(epoch, std::memory_order_release);
+    return true;
+}
+
+// The protection of this range was removed behind the write tracker, consider its tracked pages as written
+static void release_tracked_pages(MemState &state, Address addr, uint32_t size) {
+    const uint32_t end_page = (addr + size + state.page_size - 1) / state.page_size;
+    for (uint32_t page = addr / state.page_size; page < end_page; page++) {
+        if (state.write_tracking.armed[page / 64].load(std::memory_order_relaxed) & (1ULL << (page % 64)))
+            record_tracked_write(state, page);
+    }
+}
+
 bool handle_access_violation(MemState &state, uint8_t *addr, bool write) noexcept {
     const uintptr_t memory_addr = reinterpret_cast<uintptr_t>(state.memory.get());
     const uintptr_t fault_addr = reinterpret_cast<uintptr_t>(addr);
@@ -288,7 +329,16 @@ bool handle_access_violation(MemState &state, uint8_t *addr, bool write) noexcep
         fmt::print("Access: {}\n", log_hex(vaddr));
     }
 
+    const uint32_t page = vaddr / state.page_size;
+    const bool tracked_write = write && record_tracked_write(state, page);
+
     auto it = state.protect_tree.lower_bound(vaddr);
+    if (tracked_write && (it == state.protect_tree.end() || vaddr >= it->first + it->second.size)) {
+        // only protected by the write tracker
+        unprotect_inner(state, page * state.page_size, state.page_size);
+        return true;
+    }
+
     if (it == state.protect_tree.end()) {
         // HACK: keep going
         unprotect_inner(state, align_down(vaddr, state.page_size), state.page_size);
@@ -310,6 +360,7 @@ bool handle_access_violation(MemState &state, uint8_t *addr, bool write) noexcep
     }
 
     unprotect_inner(state, it->first, info.size);
+    release_tracked_pages(state, it->first, info.size);
     state.protect_tree.erase(it);
 
     return true;
@@ -355,6 +406,56 @@ bool add_protect(MemState &state, Address addr, const uint32_t size, const MemPe
     return true;
 }
 
+WriteEpoch track_writes(MemState &state, Address addr, uint32_t size) {
+    const std::lock_guard<std::mutex> lock(state.protect_mutex);
+    align_to_page(state, addr, size);
+
+    WriteTrackingState &tracking = state.write_tracking;
+    const uint32_t first_page = addr / state.page_size;
+    const uint32_t end_page = first_page + size / state.page_size;
+
+    // protect the pages which need it in as few calls as possible
+    uint32_t run_start = end_page;
+    const auto flush_run = [&](const uint32_t run_end) {
+        if (run_start < run_end)
+            protect_inner(state, run_start * state.page_size, (run_end - run_start) * state.page_size, MemPerm::ReadOnly);
+        run_start = end_page;
+    };
+
+    for (uint32_t page = first_page; page < end_page; page++) {
+        const uint64_t bit = 1ULL << (page % 64);
+        if (tracking.armed[page / 64].fetch_or(bit, std::memory_order_acq_rel) & bit) {
+            // still protected since the last call
+            flush_run(page);
+            continue;
+        }
+
+        // pages in the protect tree already fault on write, do not loosen their protection
+        const Address page_addr = page * state.page_size;
+        const auto it = state.protect_tree.lower_bound(page_addr);
+        if (it != state.protect_tree.end() && page_addr < it->first + it->second.size) {
+            flush_run(page);
+            continue;
+        }
+
+        if (run_start == end_page)
+            run_start = page;
+    }
+    flush_run(end_page);
+
+    return tracking.epoch.load(std::memory_order_acquire);
+}
+
+bool is_range_written(const MemState &state, Address addr, uint32_t size, WriteEpoch since) {
+    const uint32_t end_page = (addr + size + state.page_size - 1) / state.page_size;
+    for (uint32_t page = addr / state.page_size; page < end_page; page++) {
+        if (state.write_tracking.page_epochs[page].load(std::memory_order_acquire) > since)
+            return true;
+    }
+
+    return false;
+}
+
 bool is_protecting(MemState &state, Address addr, MemPerm *perm) {
     const std::lock_guard<std::mutex> lock(state.protect_mutex);
     auto ite = state.protect_tree.lower_bound(addr);
@@ -409,6 +510,7 @@ void remove_external_mapping(MemState &mem, uint8_t *addr_ptr, uint32_t size) {
 
     // remove all protections on this range
     unprotect_inner(mem, mapping.address, mapping.size);
+    release_tracked_pages(mem, mapping.address, mapping.size);
     {
         const std::unique_lock<std::mutex> lock(mem.protect_mutex);
         auto prot_it = mem.protect_tree.lower_bound(mapping.address);
@@ -493,17 +595,9 @@ void free(MemState &state, Address address) {
     }
 
     assert(!state.use_page_table || state.page_table[address / KiB(4)] == state.memory.get());
-    uint8_t *const memory = &state.memory[page_num * state.page_size];
-
-#ifdef WIN32
-    const BOOL ret = VirtualFree(memory, page.size * state.page_size, MEM_DECOMMIT);
-    LOG_CRITICAL_IF(!ret, "VirtualFree failed: {}", get_error_msg());
-#else
-    int ret = mprotect(memory, page.size * state.page_size, PROT_NONE);
-    LOG_CRITICAL_IF(ret == -1, "mprotect failed: {}", get_error_msg());
-    ret = madvise(memory, page.size * state.page_size, MADV_DONTNEED);
-    LOG_CRITICAL_IF(ret == -1, "madvise failed: {}", get_error_msg());
-#endif
+    decommit_pages(state, page_num, page.size);
+    // the pages will be accessible again on the next allocation
+    release_tracked_pages(state, page_num * state.page_size, page.size * state.page_size);
 }
 
 uint32_t mem_available(MemState &state) {
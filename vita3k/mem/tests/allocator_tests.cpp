@@ -21,6 +21,13 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <random>
+#include <vector>
+
 TEST(bitmap_allocator, one_bit_allocation) {
     BitmapAllocator allocator(KiB(5));
 
@@ -243,3 +250,114 @@ TEST(bitmap_allocator, count_unaligned) {
     // 4 valid bits + 12 bits + 5 valid bits = 21
     ASSERT_EQ(alloc.free_slot_count(22, 92), 21);
 }
+
+// Straightforward model of the allocator, used to check the results of the summarized search
+struct ReferenceAllocator {
+    std::vector<bool> free_bits;
+
+    explicit ReferenceAllocator(const size_t total_bits)
+        : free_bits(total_bits, true) {}
+
+    int allocate_from(const uint32_t start_offset, const int size, const bool best_fit) {
+        int best_offset = -1;
+        int best_length = INT_MAX;
+        size_t i = start_offset & ~31U;
+        while (i < free_bits.size()) {
+            if (!free_bits[i]) {
+                i++;
+                continue;
+            }
+
+            const size_t run_offset = i;
+            while (i < free_bits.size() && free_bits[i])
+                i++;
+            const int run_length = static_cast<int>(i - run_offset);
+            if (run_length >= size && run_length < best_length) {
+                best_offset = static_cast<int>(run_offset);
+                best_length = run_length;
+                if (!best_fit)
+                    break;
+            }
+        }
+
+        if (best_offset >= 0)
+            std::fill_n(free_bits.begin() + best_offset, size, false);
+        return best_offset;
+    }
+
+    void free(const uint32_t offset, const int size) {
+        std::fill_n(free_bits.begin() + offset, size, true);
+    }
+};
+
+TEST(bitmap_allocator, matches_reference) {
+    constexpr int MEM_SIZE = KiB(64) + 77;
+    constexpr int TEST_EPOCH = KiB(50);
+    std::mt19937 rng(1234);
+
+    BitmapAllocator allocator(MEM_SIZE);
+    ReferenceAllocator reference(MEM_SIZE);
+    std::vector<std::pair<int, int>> pages;
+
+    for (int i = 0; i < TEST_EPOCH; ++i) {
+        if (!pages.empty() && rng() % 5 < 2) {
+            const size_t index = rng() % pages.size();
+            allocator.free(pages[index].first, pages[index].second);
+            reference.free(pages[index].first, pages[index].second);
+            pages[index] = pages.back();
+            pages.pop_back();
+            continue;
+        }
+
+        // mostly small allocations with a few big ones spanning several groups
+        int size = (rng() % 16 == 0) ? static_cast<int>(rng() % KiB(8)) + 1 : static_cast<int>(rng() % 64) + 1;
+        const uint32_t start_offset = (rng() % 4 == 0) ? rng() % MEM_SIZE : 0;
+        const bool best_fit = rng() % 2;
+        const int expected = reference.allocate_from(start_offset, size, best_fit);
+        const int offset = allocator.allocate_from(start_offset, size, best_fit);
+        ASSERT_EQ(offset, expected);
+        if (offset >= 0)
+            pages.emplace_back(offset, size);
+    }
+
+    int free_count = 0;
+    for (int i = 0; i < MEM_SIZE; i++) {
+        ASSERT_EQ(allocator.free_slot_count(i, i + 1), reference.free_bits[i] ? 1 : 0);
+        free_count += reference.free_bits[i];
+    }
+    ASSERT_EQ(allocator.free_slot_count(0, MEM_SIZE), free_count);
+}
+
+// Not a correctness test: prints the allocator throughput on a map the size of the guest address space
+TEST(bitmap_allocator, DISABLED_benchmark) {
+    constexpr size_t TOTAL_BITS = GiB(4) / KiB(4);
+    constexpr int ITERATIONS = 20000;
+    std::mt19937 rng(42);
+
+    BitmapAllocator allocator(TOTAL_BITS);
+    std::vector<std::pair<int, int>> pages;
+
+    // fill most of the space first, like a game which allocated its whole budget
+    int size = static_cast<int>(TOTAL_BITS - KiB(16));
+    ASSERT_EQ(allocator.allocate_from(0, size), 0);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; ++i) {
+        if (!pages.empty() && rng() % 2 == 0) {
+            const size_t index = rng() % pages.size();
+            allocator.free(pages[index].first, pages[index].second);
+            pages[index] = pages.back();
+            pages.pop_back();
+        }
+
+        size = static_cast<int>(rng() % 16) + 1;
+        const int offset = allocator.allocate_from(0, size, i % 2);
+        if (offset >= 0)
+            pages.emplace_back(offset, size);
+        ASSERT_EQ(allocator.free_slot_count(offset >= 0 ? offset : 0, offset >= 0 ? offset + 1 : 1), 0);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    printf("%d allocations on %zu pages: %.1f us per allocation\n", ITERATIONS, TOTAL_BITS,
+        static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / ITERATIONS / 1000.0);
+}
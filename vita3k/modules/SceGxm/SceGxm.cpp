@@ -38,6 +38,7 @@
 #include <SDL.h>
 #include <io/state.h>
 #include <mem/allocator.h>
+#include <mem/functions.h>
 #include <mem/mempool.h>
 #include <renderer/functions.h>
 #include <renderer/state.h>
@@ -980,10 +981,13 @@ struct SceGxmCommandList {
     // the locations on the vita memory that correspond to this command list
     // this part is not copied in the command list given to the game by endCommandList
     std::stack<RangeIterator> memory_ranges;
+
+    // host memory of the commands, freed together with the command list
+    renderer::CommandArena arena;
 };
 
 // Seems on real vita, this is the maximum size, I got stack corrupt if try to write more
-static_assert(sizeof(SceGxmCommandList) - sizeof(std::stack<CommandListRange>) <= 32);
+static_assert(sizeof(SceGxmCommandList) - sizeof(std::stack<CommandListRange>) - sizeof(renderer::CommandArena) <= 32);
 
 struct SceGxmContext {
     GxmContextState state;
@@ -1018,6 +1022,11 @@ struct SceGxmContext {
     bool was_vert_default_uniform_reserved = false;
     bool was_frag_default_uniform_reserved = false;
 
+    // value of GxmState::program_release_count when the programs were last set
+    // a program can be released then created again at the same address, it must be set again in this case
+    uint32_t vertex_program_release_count = 0;
+    uint32_t fragment_program_release_count = 0;
+
     explicit SceGxmContext(std::mutex &callback_lock_)
         : callback_lock(callback_lock_) {
     }
@@ -1028,15 +1037,7 @@ struct SceGxmContext {
 
     void free_command_list(SceGxmCommandList *command_list) {
         // command list has been overwritten, free the memory
-        // everything except the command_list except was allocated using malloc
-        renderer::Command *cmd = command_list->list->first;
-        while (cmd != command_list->list->last) {
-            renderer::Command *next = cmd->next;
-            free(cmd);
-            cmd = next;
-        }
-        free(cmd);
-        free(command_list->list);
+        // the commands and the list itself live in the command list arena, which is released on delete
 
         // we also need to delete all ranges occupied by this list
         while (!command_list->memory_ranges.empty()) {
@@ -1148,7 +1149,7 @@ struct SceGxmContext {
         alloc_space = alloc_space + allocated_on_vdm;
 
         // the data returned is not part of the vita memory (our commands are too big and do not fit)
-        return reinterpret_cast<uint8_t *>(malloc(size));
+        return reinterpret_cast<uint8_t *>(curr_command_list->arena.allocate(size));
     }
 
     template <typename T>
@@ -1385,6 +1386,8 @@ static void gxmContextStateRestore(renderer::State &state, MemState &mem, SceGxm
     renderer::set_polygon_mode(state, context->renderer.get(), true, context->state.front_polygon_mode);
     renderer::set_polygon_mode(state, context->renderer.get(), false, context->state.back_polygon_mode);
     renderer::set_two_sided_enable(state, context->renderer.get(), context->state.two_sided);
+    renderer::set_side_fragment_program_enable(state, context->renderer.get(), true, context->state.front_side_fragment_program_mode);
+    renderer::set_side_fragment_program_enable(state, context->renderer.get(), false, context->state.back_side_fragment_program_mode);
     renderer::set_stencil_func(state, context->renderer.get(), true, context->state.front_stencil.func, context->state.front_stencil.stencil_fail,
         context->state.front_stencil.depth_fail, context->state.front_stencil.depth_pass, context->state.front_stencil.compare_mask,
         context->state.front_stencil.write_mask);
@@ -2147,6 +2150,57 @@ static void gxmSetUniformBuffers(renderer::State &state, GxmState &gxm, SceGxmCo
     }
 }
 
+// Index buffers at least this big get their max index cached while their memory is not written to
+static constexpr uint32_t MIN_CACHED_INDEX_COUNT = 1024;
+// Buffers invalidated this many times are considered dynamic and scanned on every draw
+static constexpr uint32_t MAX_INDEX_RANGE_INVALIDATIONS = 4;
+static constexpr size_t MAX_INDEX_RANGE_CACHE_SIZE = 4096;
+
+static uint32_t gxmGetMaxIndex(GxmState &gxm, MemState &mem, SceGxmIndexFormat indexType, Ptr<const void> indexData, uint32_t indexCount) {
+    const void *indices_ptr = indexData.get(mem);
+    if (indexCount < MIN_CACHED_INDEX_COUNT)
+        return gxm::get_index_range(indices_ptr, indexCount, indexType).max;
+
+    const uint64_t key = (static_cast<uint64_t>(indexData.address()) << 32) | indexCount;
+    const uint32_t size = indexCount * gxm::index_element_size(indexType);
+    bool track = false;
+    WriteEpoch write_epoch = 0;
+    {
+        const std::lock_guard<std::mutex> guard(gxm.index_range_cache_mutex);
+        if (gxm.index_range_cache.size() >= MAX_INDEX_RANGE_CACHE_SIZE)
+            gxm.index_range_cache.clear();
+
+        const auto [it, is_new] = gxm.index_range_cache.try_emplace(key);
+        IndexRangeCacheEntry &entry = it->second;
+        if (!is_new && entry.invalidation_count < MAX_INDEX_RANGE_INVALIDATIONS) {
+            if (!is_range_written(mem, indexData.address(), size, entry.write_epoch)) {
+                if (entry.format == indexType)
+                    return entry.max_index;
+            } else {
+                entry.invalidation_count++;
+            }
+        }
+
+        track = entry.invalidation_count < MAX_INDEX_RANGE_INVALIDATIONS;
+        if (track)
+            // arm before scanning so that a write happening during the scan is not missed
+            write_epoch = track_writes(mem, indexData.address(), size);
+    }
+
+    // scan without holding the lock, other contexts keep drawing meanwhile
+    const uint32_t max_index = gxm::get_index_range(indices_ptr, indexCount, indexType).max;
+
+    const std::lock_guard<std::mutex> guard(gxm.index_range_cache_mutex);
+    // the entry may have been evicted in the meantime, then it is simply added again
+    IndexRangeCacheEntry &entry = gxm.index_range_cache[key];
+    // the result is stored with the epoch armed before its own scan, so it never looks fresher than it is
+    if (track)
+        entry.write_epoch = write_epoch;
+    entry.format = indexType;
+    entry.max_index = max_index;
+    return max_index;
+}
+
 static int gxmDrawElementGeneral(EmuEnvState &emuenv, const char *export_name, const SceUID thread_id, SceGxmContext *context, SceGxmPrimitiveType primType, SceGxmIndexFormat indexType, Ptr<const void> indexData, uint32_t indexCount, uint32_t instanceCount) {
     if (!context || !indexData)
         return RET_ERROR(SCE_GXM_ERROR_INVALID_POINTER);
@@ -2170,8 +2224,6 @@ static int gxmDrawElementGeneral(EmuEnvState &emuenv, const char *export_name, c
     const SceGxmProgram &vertex_program_gxp = *gxm_vertex_program.program.get(emuenv.mem);
     const SceGxmProgram &fragment_program_gxp = *gxm_fragment_program.program.get(emuenv.mem);
 
-    const void *indices_ptr = indexData.get(emuenv.mem);
-
     gxmSetUniformBuffers(*emuenv.renderer, emuenv.gxm, context, vertex_program_gxp, context->state.vertex_uniform_buffers, gxm_vertex_program.renderer_data->uniform_buffer_sizes,
         emuenv.kernel, emuenv.mem, thread_id);
     gxmSetUniformBuffers(*emuenv.renderer, emuenv.gxm, context, fragment_program_gxp, context->state.fragment_uniform_buffers, gxm_fragment_program.renderer_data->uniform_buffer_sizes,
@@ -2207,13 +2259,7 @@ static int gxmDrawElementGeneral(EmuEnvState &emuenv, const char *export_name, c
     size_t max_index = 0;
     if (!emuenv.renderer->features.enable_memory_mapping) {
         // we don't need to get the vertex buffer size with memory mapping
-        if (indexType == SCE_GXM_INDEX_FORMAT_U16) {
-            const uint16_t *const data = reinterpret_cast<const uint16_t *>(indices_ptr);
-            max_index = *std::max_element(&data[0], &data[indexCount]);
-        } else {
-            const uint32_t *const data = reinterpret_cast<const uint32_t *>(indices_ptr);
-            max_index = *std::max_element(&data[0], &data[indexCount]);
-        }
+        max_index = gxmGetMaxIndex(emuenv.gxm, emuenv.mem, indexType, indexData, indexCount);
     }
 
     size_t max_data_length[SCE_GXM_MAX_VERTEX_STREAMS] = {};
@@ -3554,7 +3600,10 @@ EXPORT(void, sceGxmSetBackDepthWriteEnable, SceGxmContext *context, SceGxmDepthW
 
 EXPORT(void, sceGxmSetBackFragmentProgramEnable, SceGxmContext *context, SceGxmFragmentProgramMode enable) {
     TRACY_FUNC(sceGxmSetBackFragmentProgramEnable, context, enable);
-    renderer::set_side_fragment_program_enable(*emuenv.renderer, context->renderer.get(), false, enable);
+    if (context->state.back_side_fragment_program_mode != enable) {
+        context->state.back_side_fragment_program_mode = enable;
+        renderer::set_side_fragment_program_enable(*emuenv.renderer, context->renderer.get(), false, enable);
+    }
 }
 
 EXPORT(void, sceGxmSetBackLineFillLastPixelEnable, SceGxmContext *context, SceGxmLineFillLastPixelMode enable) {
@@ -3742,7 +3791,13 @@ EXPORT(void, sceGxmSetFragmentProgram, SceGxmContext *context, Ptr<const SceGxmF
     if (!context || !fragmentProgram)
         return;
 
+    // engines setting the whole state before each draw often set the same program again
+    const uint32_t program_release_count = emuenv.gxm.program_release_count.load();
+    if (context->state.fragment_program == fragmentProgram && context->fragment_program_release_count == program_release_count)
+        return;
+
     context->state.fragment_program = fragmentProgram;
+    context->fragment_program_release_count = program_release_count;
     renderer::set_program(*emuenv.renderer, context->renderer.get(), fragmentProgram, true);
 }
 
@@ -3810,7 +3865,10 @@ EXPORT(void, sceGxmSetFrontDepthWriteEnable, SceGxmContext *context, SceGxmDepth
 
 EXPORT(void, sceGxmSetFrontFragmentProgramEnable, SceGxmContext *context, SceGxmFragmentProgramMode enable) {
     TRACY_FUNC(sceGxmSetFrontFragmentProgramEnable, context, enable);
-    renderer::set_side_fragment_program_enable(*emuenv.renderer, context->renderer.get(), true, enable);
+    if (context->state.front_side_fragment_program_mode != enable) {
+        context->state.front_side_fragment_program_mode = enable;
+        renderer::set_side_fragment_program_enable(*emuenv.renderer, context->renderer.get(), true, enable);
+    }
 }
 
 EXPORT(void, sceGxmSetFrontLineFillLastPixelEnable, SceGxmContext *context, SceGxmLineFillLastPixelMode enable) {
@@ -4126,7 +4184,12 @@ EXPORT(void, sceGxmSetVertexProgram, SceGxmContext *context, Ptr<const SceGxmVer
     if (!context || !vertexProgram)
         return;
 
+    const uint32_t program_release_count = emuenv.gxm.program_release_count.load();
+    if (context->state.vertex_program == vertexProgram && context->vertex_program_release_count == program_release_count)
+        return;
+
     context->state.vertex_program = vertexProgram;
+    context->vertex_program_release_count = program_release_count;
     renderer::set_program(*emuenv.renderer, context->renderer.get(), vertexProgram, false);
 }
 
@@ -4186,14 +4249,11 @@ EXPORT(void, sceGxmSetViewport, SceGxmContext *context, float xOffset, float xSc
         context->state.viewport.scale.y = yScale;
         context->state.viewport.scale.z = zScale;
 
-        if (context->alloc_space) {
-            if (context->state.viewport.enable == SCE_GXM_VIEWPORT_ENABLED) {
-                renderer::set_viewport_real(*emuenv.renderer, context->renderer.get(), context->state.viewport.offset.x,
-                    context->state.viewport.offset.y, context->state.viewport.offset.z, context->state.viewport.scale.x, context->state.viewport.scale.y,
-                    context->state.viewport.scale.z);
-            } else {
-                renderer::set_viewport_flat(*emuenv.renderer, context->renderer.get());
-            }
+        // the flat viewport is already set when the viewport is disabled, the new values are sent once it is enabled
+        if (context->alloc_space && context->state.viewport.enable == SCE_GXM_VIEWPORT_ENABLED) {
+            renderer::set_viewport_real(*emuenv.renderer, context->renderer.get(), context->state.viewport.offset.x,
+                context->state.viewport.offset.y, context->state.viewport.offset.z, context->state.viewport.scale.x, context->state.viewport.scale.y,
+                context->state.viewport.scale.z);
         }
     }
 }
@@ -4373,7 +4433,7 @@ EXPORT(int, sceGxmShaderPatcherCreateFragmentProgram, SceGxmShaderPatcher *shade
     fp->is_maskupdate = false;
     fp->program = programId->program;
 
-    if (!renderer::create(fp->renderer_data, *emuenv.renderer, *programId->program.get(mem), blendInfo, emuenv.renderer->gxp_ptr_map)) {
+    if (!renderer::create(fp->renderer_data, *emuenv.renderer, *programId->program.get(mem), programId->program_id, blendInfo, emuenv.renderer->gxp_ptr_map)) {
         return RET_ERROR(SCE_GXM_ERROR_DRIVER);
     }
 
@@ -4399,8 +4459,9 @@ EXPORT(int, sceGxmShaderPatcherCreateMaskUpdateFragmentProgram, SceGxmShaderPatc
     fp->is_maskupdate = true;
     fp->program = Ptr<const SceGxmProgram>(alloc_callbacked(emuenv, thread_id, shaderPatcher->params, size_mask_gxp));
     memcpy(const_cast<SceGxmProgram *>(fp->program.get(mem)), mask_gxp, size_mask_gxp);
+    const uint32_t program_id = emuenv.renderer->program_registry.register_program(*fp->program.get(mem));
 
-    if (!renderer::create(fp->renderer_data, *emuenv.renderer, *fp->program.get(mem), nullptr, emuenv.renderer->gxp_ptr_map)) {
+    if (!renderer::create(fp->renderer_data, *emuenv.renderer, *fp->program.get(mem), program_id, nullptr, emuenv.renderer->gxp_ptr_map)) {
         return RET_ERROR(SCE_GXM_ERROR_DRIVER);
     }
 
@@ -4452,7 +4513,7 @@ EXPORT(int, sceGxmShaderPatcherCreateVertexProgram, SceGxmShaderPatcher *shaderP
         vp->attributes.insert(vp->attributes.end(), &attributes[0], &attributes[attributeCount]);
     }
 
-    if (!renderer::create(vp->renderer_data, *emuenv.renderer, *programId->program.get(mem), emuenv.renderer->gxp_ptr_map, vp->attributes)) {
+    if (!renderer::create(vp->renderer_data, *emuenv.renderer, *programId->program.get(mem), programId->program_id, emuenv.renderer->gxp_ptr_map, vp->attributes)) {
         return RET_ERROR(SCE_GXM_ERROR_DRIVER);
     }
 
@@ -4584,6 +4645,8 @@ EXPORT(int, sceGxmShaderPatcherRegisterProgram, SceGxmShaderPatcher *shaderPatch
 
     SceGxmRegisteredProgram *const rp = programId->get(emuenv.mem);
     rp->program = programHeader;
+    // hash the program only once, all the programs created from it share its id
+    rp->program_id = emuenv.renderer->program_registry.register_program(*programHeader.get(emuenv.mem));
 
     return 0;
 }
@@ -4606,6 +4669,7 @@ EXPORT(int, sceGxmShaderPatcherReleaseFragmentProgram, SceGxmShaderPatcher *shad
             }
         }
         free_callbacked(emuenv, thread_id, shaderPatcher, fragmentProgram);
+        emuenv.gxm.program_release_count++;
     }
 
     return 0;
@@ -4629,6 +4693,7 @@ EXPORT(int, sceGxmShaderPatcherReleaseVertexProgram, SceGxmShaderPatcher *shader
             }
         }
         free_callbacked(emuenv, thread_id, shaderPatcher, vertexProgram);
+        emuenv.gxm.program_release_count++;
     }
 
     return 0;
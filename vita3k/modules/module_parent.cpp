@@ -35,6 +35,7 @@
 #include <util/log.h>
 #include <util/string_utils.h>
 
+#include <iterator>
 #include <unordered_set>
 
 static constexpr bool LOG_UNK_NIDS_ALWAYS = false;
@@ -65,6 +66,15 @@ static ImportFn resolve_import(uint32_t nid) {
     return ImportFn();
 }
 
+// Indexed by import_index(nid)
+static const ImportFn *const import_table[] = {
+#define VAR_NID(name, nid)
+#define NID(name, nid) &import_##name,
+#include <nids/nids.inc>
+#undef NID
+#undef VAR_NID
+};
+
 const std::array<VarExport, var_exports_size> &get_var_exports() {
     static std::array<VarExport, var_exports_size> var_exports = { {
 #define NID(name, nid)
@@ -97,6 +107,12 @@ Address resolve_export(KernelState &kernel, uint32_t nid) {
     return export_address->second;
 }
 
+static const std::unordered_set<uint32_t> hle_nid_blacklist = {
+    0xB295EB61, // sceKernelGetTLSAddr
+    0x46E7BE7B, // sceKernelLockLwMutex
+    0x91FA6614, // sceKernelUnlockLwMutex
+};
+
 static void log_import_call(char emulation_level, uint32_t nid, SceUID thread_id, const std::unordered_set<uint32_t> &nid_blacklist, Address lr) {
     if (!nid_blacklist.contains(nid)) {
         const char *const name = import_name(nid);
@@ -110,14 +126,10 @@ void call_import(EmuEnvState &emuenv, CPUState &cpu, uint32_t nid, SceUID thread
     if (!export_pc) {
         // HLE - call our C++ function
         if (emuenv.kernel.debugger.watch_import_calls) {
-            const std::unordered_set<uint32_t> hle_nid_blacklist = {
-                0xB295EB61, // sceKernelGetTLSAddr
-                0x46E7BE7B, // sceKernelLockLwMutex
-                0x91FA6614, // sceKernelUnlockLwMutex
-            };
             auto lr = read_lr(cpu);
             log_import_call('H', nid, thread_id, hle_nid_blacklist, lr);
         }
+        emuenv.kernel.hle_call_count.fetch_add(1, std::memory_order_relaxed);
         const ImportFn fn = resolve_import(nid);
         if (fn) {
             fn(emuenv, cpu, thread_id);
@@ -156,11 +168,30 @@ void call_import(EmuEnvState &emuenv, CPUState &cpu, uint32_t nid, SceUID thread
         const std::unordered_set<uint32_t> lle_nid_blacklist = {};
         log_import_call('L', nid, thread_id, lle_nid_blacklist, pc);
         write_pc(cpu, export_pc);
-        // TODO: invalidate cache for all threads. Now invalidate_jit_cache is not thread safe.
-        invalidate_jit_cache(cpu, pc, 4 * 3);
+        // the stub may already be translated by other threads (or by the shared jit cache)
+        emuenv.kernel.invalidate_jit_cache(pc, 4 * 3);
     }
 }
 
+void call_hle_import(EmuEnvState &emuenv, CPUState &cpu, uint32_t index, SceUID thread_id) {
+    emuenv.kernel.hle_call_count.fetch_add(1, std::memory_order_relaxed);
+
+    // the index comes from the svc immediate, which the guest can set to anything
+    if (index >= std::size(import_table)) {
+        LOG_ERROR("HLE import index {} is out of range (thread ID: {}, lr: {})", index, thread_id, log_hex(read_lr(cpu)));
+        // make the function return 0, like an unimplemented import
+        write_reg(cpu, 0, 0);
+        return;
+    }
+
+    if (emuenv.kernel.debugger.watch_import_calls) {
+        auto lr = read_lr(cpu);
+        log_import_call('H', import_nid(index), thread_id, hle_nid_blacklist, lr);
+    }
+
+    (*import_table[index])(emuenv, cpu, thread_id);
+}
+
 SceUID load_module(EmuEnvState &emuenv, const std::string &module_path) {
     // Check if module is already loaded
     const auto &loaded_modules = emuenv.kernel.loaded_modules;
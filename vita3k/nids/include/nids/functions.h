@@ -20,3 +20,9 @@
 #include <cstdint>
 
 const char *import_name(uint32_t nid);
+
+// Functions NIDs are numbered in nids.inc order so HLE imports can be dispatched from a flat table
+constexpr uint32_t INVALID_IMPORT_INDEX = 0xFFFFFFFF;
+
+uint32_t import_index(uint32_t nid);
+uint32_t import_nid(uint32_t index);
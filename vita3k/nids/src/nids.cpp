@@ -17,6 +17,9 @@
 
 #include <nids/functions.h>
 
+#include <iterator>
+#include <unordered_map>
+
 #define VAR_NID(name, nid) extern const char name_##name[] = #name;
 #define NID(name, nid) extern const char name_##name[] = #name;
 #include <nids/nids.inc>
@@ -38,3 +41,31 @@ const char *import_name(uint32_t nid) {
         return "UNRECOGNISED";
     }
 }
+
+static constexpr uint32_t import_nids[] = {
+#define VAR_NID(name, nid)
+#define NID(name, nid) nid,
+#include <nids/nids.inc>
+#undef NID
+#undef VAR_NID
+};
+
+uint32_t import_index(uint32_t nid) {
+    static const std::unordered_map<uint32_t, uint32_t> indices = []() {
+        std::unordered_map<uint32_t, uint32_t> result;
+        for (uint32_t i = 0; i < std::size(import_nids); i++)
+            result.emplace(import_nids[i], i);
+        return result;
+    }();
+
+    const auto it = indices.find(nid);
+    if (it == indices.end())
+        return INVALID_IMPORT_INDEX;
+    return it->second;
+}
+
+uint32_t import_nid(uint32_t index) {
+    if (index >= std::size(import_nids))
+        return 0;
+    return import_nids[index];
+}
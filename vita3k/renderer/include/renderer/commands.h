@@ -18,8 +18,10 @@
 #pragma once
 
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <vector>
 
 #include <dlmalloc.h>
@@ -84,7 +86,9 @@ enum class CommandOpcode : std::uint8_t {
     NewFrame,
 
     DestroyRenderTarget,
-    DestroyContext
+    DestroyContext,
+
+    Count
 };
 
 enum CommandErrorCode {
@@ -112,6 +116,24 @@ struct Command {
 
 using CommandPool = std::vector<Command>;
 
+// Bump allocator handing out memory from contiguous blocks, everything is released at once.
+// Used for the commands of deferred command lists, which all die together.
+class CommandArena {
+public:
+    void *allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+    template <typename T>
+    T *allocate() {
+        return static_cast<T *>(allocate(sizeof(T), alignof(T)));
+    }
+
+private:
+    static constexpr std::size_t BLOCK_SIZE = 16 * 1024;
+
+    std::vector<std::unique_ptr<std::uint8_t[]>> blocks;
+    std::size_t block_offset = BLOCK_SIZE;
+};
+
 // It's to split a command list easier when ExecuteCommandList is used.
 struct CommandList {
     Command *first{ nullptr };
@@ -23,6 +23,7 @@
 struct MemState;
 struct FeatureState;
 struct Config;
+class ThreadPool;
 
 namespace renderer {
 struct Context;
@@ -31,8 +32,8 @@ struct RenderTarget;
 struct State;
 struct VertexProgram;
 
-bool create(std::unique_ptr<FragmentProgram> &fp, State &state, const SceGxmProgram &program, const SceGxmBlendInfo *blend, GXPPtrMap &gxp_ptr_map);
-bool create(std::unique_ptr<VertexProgram> &vp, State &state, const SceGxmProgram &program, GXPPtrMap &gxp_ptr_map, const std::vector<SceGxmVertexAttribute> &attributes);
+bool create(std::unique_ptr<FragmentProgram> &fp, State &state, const SceGxmProgram &program, uint32_t program_id, const SceGxmBlendInfo *blend, GXPPtrMap &gxp_ptr_map);
+bool create(std::unique_ptr<VertexProgram> &vp, State &state, const SceGxmProgram &program, uint32_t program_id, GXPPtrMap &gxp_ptr_map, const std::vector<SceGxmVertexAttribute> &attributes);
 void create(SceGxmSyncObject *sync, State &state);
 void destroy(SceGxmSyncObject *sync, State &state);
 void finish(State &state, Context *context);
@@ -234,6 +235,8 @@ void convert_u2f10f10f10_to_f16f16f16f16(void *dest, const void *data, const uin
 
 void swizzled_texture_to_linear_texture(uint8_t *dest, const uint8_t *src, uint16_t width, uint16_t height, uint8_t bits_per_pixel);
 void tiled_texture_to_linear_texture(uint8_t *dest, const uint8_t *src, uint16_t width, uint16_t height, uint8_t bits_per_pixel);
+void linear_texture_to_swizzled_texture(uint8_t *dest, const uint8_t *src, uint16_t width, uint16_t height, uint8_t bits_per_pixel);
+void linear_texture_to_tiled_texture(uint8_t *dest, const uint8_t *src, uint16_t width, uint16_t height, uint8_t bits_per_pixel);
 
 uint16_t get_upload_mip(const uint16_t true_mip, const uint16_t width, const uint16_t height);
 
@@ -242,7 +245,8 @@ uint32_t decode_morton2_y(uint32_t code);
 uint32_t encode_morton(uint16_t x, uint16_t y, uint16_t width, uint16_t height);
 bool can_texture_be_unswizzled_without_decode(SceGxmTextureBaseFormat fmt, bool is_vulkan);
 uint32_t get_compressed_size(SceGxmTextureBaseFormat base_format, uint32_t width, uint32_t height);
-uint64_t hash_texture_data(const SceGxmTexture &texture, uint32_t texture_size, const MemState &mem);
+// large textures are hashed by chunks, spread on pool if it is given
+uint64_t hash_texture_data(const SceGxmTexture &texture, uint32_t texture_size, const MemState &mem, ThreadPool *pool = nullptr);
 // hash texture used for texture replacement such that byte in the stride are not hashed
 // this prevent texture duplication in case there are random bytes in the stride
 uint64_t hash_texture_nostride(const SceGxmTexture &texture, const MemState &mem);
@@ -36,11 +36,15 @@ struct FeatureState;
 namespace renderer::gl {
 
 // Compile program.
-SharedGLObject compile_program(GLState &renderer, GLContext &context, const GxmRecordState &state, const FeatureState &features, const MemState &mem, bool shader_cache, bool spirv, bool maskupdate);
+// is_compiling is set if the program is being compiled in the background, the draw must then be skipped
+SharedGLObject compile_program(GLState &renderer, GLContext &context, const GxmRecordState &state, const FeatureState &features, const MemState &mem,
+    bool shader_cache, bool spirv, bool maskupdate, bool consider_for_async, bool &is_compiling);
 void pre_compile_program(GLState &renderer, const ShadersHash &hashs);
 
 // Uniforms.
-bool set_uniform_buffer(GLContext &context, const ShaderProgram *program, const bool vertex_shader, const int block_num, const int size, const uint8_t *data);
+void set_uniform_buffer(GLContext &context, const ShaderProgram *program, const bool vertex_shader, const int block_num, const int size, const uint8_t *data);
+// upload the uniform buffers set since the previous draw if they changed and bind them
+bool upload_uniform_storage(GLState &renderer, GLContext &context, const ShaderProgram *program, const bool vertex_shader);
 
 bool create(SDL_Window *window, std::unique_ptr<renderer::State> &state, const Config &config);
 bool create(std::unique_ptr<Context> &context);
@@ -73,7 +77,6 @@ void sync_blending(const GxmRecordState &state, const MemState &mem);
 void sync_texture(GLState &state, GLContext &context, MemState &mem, std::size_t index, SceGxmTexture texture, const Config &config);
 void sync_vertex_streams_and_attributes(GLContext &context, GxmRecordState &state, const MemState &mem);
 void bind_fundamental(GLContext &context);
-void clear_previous_uniform_storage(GLContext &context);
 
 struct GLTextureCacheState;
 struct TextureCacheState;
@@ -38,6 +38,12 @@ struct GLState : public renderer::State {
     ShaderCache fragment_shader_cache;
     ShaderCache vertex_shader_cache;
     ProgramCache program_cache;
+    PendingProgramCache pending_programs;
+
+    bool support_parallel_shader_compile = false;
+    bool use_async_compilation = false;
+    // driver which created the program binaries of the shader pack, empty if they are not supported
+    std::string program_binary_driver;
 
     GLTextureCache texture_cache;
     GLSurfaceCache surface_cache;
@@ -60,6 +66,7 @@ struct GLState : public renderer::State {
     void set_screen_filter(const std::string_view &filter) override;
     int get_max_anisotropic_filtering() override;
     void set_anisotropic_filtering(int anisotropic_filtering) override;
+    void set_async_compilation(bool enable) override;
 
     void precompile_shader(const ShadersHash &hash) override;
     void preclose_action() override;
@@ -24,6 +24,7 @@
 
 #include <renderer/gl/ring_buffer.h>
 #include <renderer/texture_cache.h>
+#include <renderer/uniform_staging.h>
 #include <shader/usse_program_analyzer.h>
 
 #include <map>
@@ -49,7 +50,16 @@ inline bool operator==(const ExcludedUniform &lhs, const ExcludedUniform &rhs) {
 }
 
 typedef std::map<Sha256Hash, SharedGLObject> ShaderCache;
-typedef std::map<ProgramHashes, SharedGLObject> ProgramCache;
+typedef std::map<ProgramIds, SharedGLObject> ProgramCache;
+
+// program linked by the driver in the background (GL_KHR_parallel_shader_compile)
+struct PendingProgram {
+    SharedGLObject program;
+    SharedGLObject fragment_shader;
+    SharedGLObject vertex_shader;
+    Sha256Hash binary_key;
+};
+typedef std::map<ProgramIds, PendingProgram> PendingProgramCache;
 typedef std::vector<ExcludedUniform> ExcludedUniforms; // vector instead of unordered_set since it's much faster for few elements
 typedef std::map<GLuint, GLenum> UniformTypes;
 
@@ -85,8 +95,12 @@ struct GLContext : public renderer::Context {
     GLuint current_color_attachment{ 0 };
     GLuint current_framebuffer_height{ 0 };
 
-    std::pair<std::uint8_t *, std::size_t> vertex_uniform_buffer_storage_ptr{ nullptr, 0 };
-    std::pair<std::uint8_t *, std::size_t> fragment_uniform_buffer_storage_ptr{ nullptr, 0 };
+    // uniform buffers of the next draw, uploaded to the uniform stream ring buffers only when they change
+    UniformStaging vertex_uniform_staging;
+    UniformStaging fragment_uniform_staging;
+    // offset in the ring buffers of the last uploaded uniform storage
+    std::size_t vertex_uniform_buffer_storage_offset = 0;
+    std::size_t fragment_uniform_buffer_storage_offset = 0;
 
     shader::RenderVertUniformBlock previous_vert_info;
     shader::RenderFragUniformBlock previous_frag_info;
@@ -293,6 +293,8 @@ struct SceGxmNotification {
 struct SceGxmRegisteredProgram {
     // TODO This is an opaque type.
     Ptr<const SceGxmProgram> program;
+    // given by the renderer program registry
+    uint32_t program_id;
 };
 
 typedef Ptr<SceGxmRegisteredProgram> SceGxmShaderPatcherId;
@@ -0,0 +1,74 @@
+// Vita3K emulator project
+// Copyright (C) 2024 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#pragma once
+
+#include <renderer/state.h>
+#include <renderer/texture_cache.h>
+#include <renderer/types.h>
+
+struct Config;
+
+namespace renderer::null {
+
+// nothing is drawn, so no texture is ever selected or uploaded
+class NullTextureCache : public TextureCache {
+public:
+    void select(size_t index, const SceGxmTexture &texture) override {}
+    void configure_texture(const SceGxmTexture &texture) override {}
+    void upload_texture_impl(SceGxmTextureBaseFormat base_format, uint32_t width, uint32_t height, uint32_t mip_index, const void *pixels, int face, uint32_t pixels_per_stride) override {}
+    void import_configure_impl(SceGxmTextureBaseFormat base_format, uint32_t width, uint32_t height, bool is_srgb, uint16_t nb_components, uint16_t mipcount, bool swap_rb) override {}
+};
+
+/**
+ * \brief Renderer which consumes the command lists without drawing anything.
+ *
+ * Sync objects and notifications are signaled and transfers are done on the cpu like with the other
+ * backends, so the emulated application runs normally. It needs no GPU and is used to measure
+ * the speed of the cpu and HLE emulation.
+ */
+struct NullState : public renderer::State {
+    MemState *mem = nullptr;
+    NullTextureCache texture_cache;
+    // set by render_frame if the game displayed a new frame since the last one
+    bool has_new_frame = false;
+
+    bool init() override;
+    void late_init(const Config &cfg, const std::string_view game_id, MemState &mem) override;
+
+    TextureCache *get_texture_cache() override {
+        return &texture_cache;
+    }
+
+    void render_frame(const SceFVector2 &viewport_pos, const SceFVector2 &viewport_size, DisplayState &display,
+        const GxmState &gxm, MemState &mem) override;
+    void swap_window(SDL_Window *window) override;
+    std::vector<uint32_t> dump_frame(DisplayState &display, uint32_t &width, uint32_t &height) override;
+
+    int get_supported_filters() override;
+    void set_screen_filter(const std::string_view &filter) override {}
+    int get_max_anisotropic_filtering() override {
+        return 1;
+    }
+    void set_anisotropic_filtering(int anisotropic_filtering) override {}
+
+    void precompile_shader(const ShadersHash &hash) override {}
+    void preclose_action() override {}
+};
+
+} // namespace renderer::null
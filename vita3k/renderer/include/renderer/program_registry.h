@@ -0,0 +1,64 @@
+// Vita3K emulator project
+// Copyright (C) 2024 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <util/hash.h>
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+struct SceGxmProgram;
+
+namespace renderer {
+
+/**
+ * \brief Gives a small integer id to each different gxm program content.
+ *
+ * Programs are identified with a fast 128-bit hash of their content, the sha256 used as the
+ * shader cache key is only computed the first time a content is seen. Ids are only valid
+ * during the current session, the same program can have another id after a reboot.
+ */
+class ProgramRegistry {
+public:
+    // can be called from multiple threads at the same time
+    uint32_t register_program(const SceGxmProgram &program);
+    // id of a program only known by its sha256, like the ones from the shader cache
+    uint32_t get_id(const Sha256Hash &hash);
+    const Sha256Hash &get_hash(uint32_t id);
+
+private:
+    struct ContentHasher {
+        size_t operator()(const std::pair<uint64_t, uint64_t> &hash) const {
+            return static_cast<size_t>(hash.first ^ hash.second);
+        }
+    };
+
+    // must be called with mutex held
+    uint32_t get_id_locked(const Sha256Hash &hash);
+
+    std::mutex mutex;
+    std::unordered_map<std::pair<uint64_t, uint64_t>, uint32_t, ContentHasher> content_ids;
+    std::map<Sha256Hash, uint32_t> hash_ids;
+    // indexed by id, references stay valid when new ids are added
+    std::deque<Sha256Hash> hashes;
+};
+} // namespace renderer
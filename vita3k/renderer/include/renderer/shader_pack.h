@@ -0,0 +1,106 @@
+// Vita3K emulator project
+// Copyright (C) 2024 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <util/fs.h>
+#include <util/hash.h>
+
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace renderer {
+class MappedFile;
+
+struct ShaderPackKey {
+    Sha256Hash hash;
+    // shader::CURRENT_VERSION when the shader was translated
+    uint32_t version;
+    // shader::Target
+    uint32_t target;
+    // State::get_features_mask() when the shader was translated
+    uint32_t features_mask;
+    uint32_t padding;
+
+    bool operator==(const ShaderPackKey &other) const = default;
+};
+
+/**
+ * \brief All the translated shaders of an application, stored in a single append-only file.
+ *
+ * The file is memory-mapped when opened and indexed by program hash, shader version, target and
+ * features mask, so that a change of one of these only misses the affected variants.
+ * Shaders stored afterwards are appended to the file and kept in memory until the next boot.
+ * Superseded and outdated entries are removed from the file once they take most of its space.
+ * Loads can be done from multiple threads at the same time.
+ */
+class ShaderPack {
+public:
+    static constexpr const char *FILE_NAME = "shaders.pack";
+
+    ShaderPack();
+    ~ShaderPack();
+
+    void open(const fs::path &path, uint32_t features_mask);
+    void close();
+    bool is_open() const {
+        return !path.empty();
+    }
+
+    // return an empty result if the shader is not in the pack
+    std::vector<uint32_t> load_spirv(const Sha256Hash &hash, uint32_t target);
+    std::string load_glsl(const Sha256Hash &hash, uint32_t target);
+    std::vector<uint8_t> load_binary(const Sha256Hash &hash, uint32_t target);
+
+    void store(const Sha256Hash &hash, uint32_t target, const void *data, size_t size);
+
+    size_t size() const;
+
+private:
+    struct KeyHasher {
+        size_t operator()(const ShaderPackKey &key) const;
+    };
+
+    struct Entry {
+        const uint8_t *data;
+        uint32_t size;
+        // position of the entry header in the file
+        uint64_t file_offset;
+    };
+
+    ShaderPackKey make_key(const Sha256Hash &hash, uint32_t target) const;
+    // must be called with mutex held, return nullptr if the shader is not in the pack
+    const Entry *find(const ShaderPackKey &key) const;
+    // rewrite the file with only the live entries, must be called before the file is mapped
+    void compact();
+
+    fs::path path;
+    uint32_t features_mask = 0;
+
+    mutable std::shared_mutex mutex;
+    std::unique_ptr<MappedFile> file;
+    std::unordered_map<ShaderPackKey, Entry, KeyHasher> entries;
+    // content of the shaders stored since the file was mapped
+    std::vector<std::unique_ptr<uint8_t[]>> stored_shaders;
+    // size of the file, not counting a partially written entry
+    uint64_t file_size = 0;
+};
+} // namespace renderer
@@ -19,8 +19,10 @@
 
 #include <features/state.h>
 #include <renderer/commands.h>
+#include <renderer/program_registry.h>
+#include <renderer/shader_pack.h>
 #include <renderer/types.h>
-#include <threads/queue.h>
+#include <threads/spsc_queue.h>
 
 #include <condition_variable>
 #include <mutex>
@@ -52,6 +54,18 @@ enum struct Filter : int {
     FSR = 1 << 4
 };
 
+// work done by the renderer during one frame
+struct FrameStats {
+    // size of the uniform storage used by the draws
+    uint64_t uniform_bytes_requested = 0;
+    // part of it which was uploaded, the uniforms of a draw are reused by the next ones while they don't change
+    uint64_t uniform_bytes_uploaded = 0;
+    // texture descriptors written or pushed by the draws (Vulkan only)
+    uint64_t descriptor_writes = 0;
+    // draws recorded as part of an indirect draw instead of on their own (Vulkan only)
+    uint64_t merged_draws = 0;
+};
+
 struct State {
     fs::path cache_path;
     fs::path log_path;
@@ -70,7 +84,9 @@ struct State {
     Context *context;
 
     GXPPtrMap gxp_ptr_map;
-    Queue<CommandList> command_buffer_queue;
+    ProgramRegistry program_registry;
+    // Filled by the GXM thread, drained by the render thread
+    SPSCQueue<CommandList, 32> command_buffer_queue;
     std::condition_variable command_finish_one;
     std::mutex command_finish_one_mutex;
 
@@ -79,6 +95,8 @@ struct State {
 
     std::vector<ShadersHash> shaders_cache_hashs;
     std::string shader_version;
+    // translated shaders of the current application
+    ShaderPack shader_pack;
 
     int last_scene_id = 0;
 
@@ -88,6 +106,10 @@ struct State {
 
     bool should_display;
 
+    // counted for the frame being rendered, then moved to last_frame_stats on each new frame
+    FrameStats frame_stats;
+    FrameStats last_frame_stats;
+
     // only support disabled by default
     int supported_mapping_methods_mask = 1;
     MappingMethod mapping_method = MappingMethod::Disabled;
@@ -139,6 +161,8 @@ struct State {
     }
 
     virtual void precompile_shader(const ShadersHash &hash) = 0;
+    // compile in the background what was used during the previous sessions, called after all shaders are precompiled
+    virtual void prewarm_pipelines() {}
     virtual void preclose_action() = 0;
 
     virtual ~State() = default;
@@ -157,6 +181,7 @@ struct State {
     void set_app(const char *title_id, const char *self_name) {
         shaders_path = cache_path / "shaders" / title_id / self_name;
         shaders_log_path = log_path / "shaderlog" / title_id / self_name;
+        shader_pack.open(shaders_path / ShaderPack::FILE_NAME, get_features_mask());
     }
 };
 } // namespace renderer
@@ -18,12 +18,17 @@
 #pragma once
 
 #include <gxm/types.h>
+#include <mem/util.h>
+#include <renderer/texture_disk_cache.h>
+#include <threads/thread_pool.h>
 #include <util/containers.h>
 #include <util/fs.h>
 
 #include <array>
 #include <cstdint>
 #include <functional>
+#include <future>
+#include <vector>
 
 namespace ddspp {
 struct Descriptor;
@@ -40,12 +45,16 @@ static constexpr size_t TextureCacheSize = 1024;
 typedef std::array<uint32_t, 4> TextureGxmDataRepr;
 struct TextureCacheInfo {
     uint64_t hash = 0;
+    // value of frame_generation when the hash was last computed
+    uint64_t hash_frame = 0;
     SceGxmTexture texture;
     int index = 0;
     uint32_t texture_size = 0;
     bool use_hash = false;
-    // no need for it to be atomic
+    // force the next upload, the writes are otherwise detected with the hash or write_epoch
     bool dirty = false;
+    // write epoch of the texture pages when it was last uploaded (or hashed if use_hash is set)
+    WriteEpoch write_epoch = 0;
     // used for texture importation
     bool is_imported = false;
     bool is_srgb = false;
@@ -61,6 +70,34 @@ struct SamplerCacheInfo {
     int index = 0;
 };
 
+struct DecodedTextureLevel {
+    SceGxmTextureBaseFormat format;
+    uint32_t width;
+    uint32_t height;
+    uint32_t mip_index;
+    // > 0 means texture cube
+    int face;
+    uint32_t pixels_per_stride;
+    const void *pixels;
+    // size of the converted pixels, 0 if they point to the guest memory
+    size_t size;
+};
+
+// texture converted to a layout and format the GPU can copy from directly
+struct DecodedTexture {
+    std::vector<DecodedTextureLevel> levels;
+    // storage for the converted levels, levels which needed no conversion point to the guest memory
+    std::vector<std::vector<uint8_t>> buffers;
+    // set instead of buffers if the texture was loaded from the disk cache
+    std::shared_ptr<MappedFile> file;
+};
+
+struct PendingTextureDecode {
+    std::future<DecodedTexture> result;
+    // the texture was modified again while it was being decoded
+    bool stale = false;
+};
+
 struct AvailableTexture {
     bool is_dds;
     std::shared_ptr<fs::path> folder_path;
@@ -100,6 +137,8 @@ public:
     // use a separate sampler cache
     bool use_sampler_cache = false;
     int anisotropic_filtering = 1;
+    // incremented at each new frame, a texture is only hashed once per frame unless its pages are written to
+    uint64_t frame_generation = 1;
 
     // used to quicky get the info from a hash of a gxm_texture
     unordered_map_fast<TextureGxmDataRepr, TextureCacheInfo *> texture_lookup;
@@ -119,6 +158,9 @@ public:
     fs::path export_folder;
     // hash of the textures that have already been exported
     unordered_set_fast<uint64_t> exported_textures_hash;
+
+    // textures which are expensive to decode are kept on the disk between boots
+    DecodedTextureDiskCache decoded_cache;
     
     // smartphone GPUs do not support DXT (BC1/2/3/4/5) textures, they must be decompressed on the GPU
     bool support_dxt = false;
@@ -129,14 +171,25 @@ public:
 
     bool init(const bool hashless_texture_cache, const fs::path &texture_folder, const std::string_view game_id, const size_t sampler_cache_size = 0);
     void set_replacement_state(bool import_textures, bool export_textures, bool export_as_png);
+    void set_async_decode(bool enable);
+    void new_frame() {
+        frame_generation++;
+    }
 
     virtual void select(size_t index, const SceGxmTexture &texture) = 0;
     virtual void configure_texture(const SceGxmTexture &texture) = 0;
     virtual void upload_texture_impl(SceGxmTextureBaseFormat base_format, uint32_t width, uint32_t height, uint32_t mip_index, const void *pixels, int face, uint32_t pixels_per_stride) = 0;
     virtual void upload_done() {}
+    // called instead of the upload on a newly configured texture whose content is being decoded asynchronously
+    virtual void clear_texture() {}
 
     virtual void configure_sampler(size_t index, const SceGxmTexture &texture, bool no_linear) {}
 
+    // convert the texture to something upload_texture_impl accepts, can be called from any thread
+    void convert_texture(const SceGxmTexture &gxm_texture, const MemState &mem, DecodedTexture &decoded) const;
+    // same as convert_texture, but goes through the disk cache if the conversion is expensive
+    void decode_texture(const SceGxmTexture &gxm_texture, const MemState &mem, DecodedTexture &decoded);
+    void upload_decoded_texture(const DecodedTexture &decoded);
     void upload_texture(const SceGxmTexture &gxm_texture, MemState &mem);
     void cache_and_bind_texture(const SceGxmTexture &gxm_texture, MemState &mem);
 
@@ -156,5 +209,19 @@ public:
     virtual void import_configure_impl(SceGxmTextureBaseFormat base_format, uint32_t width, uint32_t height, bool is_srgb, uint16_t nb_components, uint16_t mipcount, bool swap_rb) = 0;
     void import_upload_texture();
     void import_done();
+
+protected:
+    // decode textures on the worker threads, the previous content (or a cleared texture) is shown until the decode is done
+    bool async_decode = false;
+    // indexed like texture_queue.items
+    std::vector<PendingTextureDecode> pending_decodes;
+    // the pools must stay the last members so that the workers are joined before anything they use is destroyed
+    ThreadPool decode_pool;
+    // used to hash large textures in parallel, the render thread waits for it
+    ThreadPool hash_pool;
+
+    bool can_decode_async(const SceGxmTexture &gxm_texture) const;
+    // upload the result of a decode job if it is done, return false if it is still running
+    bool upload_pending_decode(TextureCacheInfo &info);
 };
 } // namespace renderer
@@ -0,0 +1,112 @@
+// Vita3K emulator project
+// Copyright (C) 2024 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <util/fs.h>
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace renderer {
+struct DecodedTexture;
+
+// read-only mapping of a whole file
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile &) = delete; // disable copying
+    MappedFile &operator=(const MappedFile &) = delete; // disable assignment
+    ~MappedFile();
+
+    bool open(const fs::path &path);
+
+    const uint8_t *data() const {
+        return content;
+    }
+    size_t size() const {
+        return content_size;
+    }
+
+private:
+    const uint8_t *content = nullptr;
+    size_t content_size = 0;
+};
+
+struct DecodedTextureDiskCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t stores;
+    uint64_t evictions;
+    uint64_t total_size; ///< Size in bytes of all the files in the cache
+};
+
+/**
+ * \brief Textures decoded by the cpu, stored on the disk to skip the decode on the next boots.
+ *
+ * There is one file per texture, named after a hash of the guest texture. A texture loaded
+ * from the cache points to the mapped file, no copy is made before the upload.
+ * Once the total size goes above max_size, the least recently used textures are removed.
+ * All functions can be called from multiple threads at the same time.
+ */
+class DecodedTextureDiskCache {
+public:
+    static constexpr uint64_t DEFAULT_MAX_SIZE = 512ULL * 1024 * 1024;
+
+    ~DecodedTextureDiskCache();
+
+    void init(const fs::path &folder, uint64_t max_size = DEFAULT_MAX_SIZE);
+    bool is_enabled() const {
+        return !folder.empty();
+    }
+
+    // return false if the texture is not in the cache
+    bool load(uint64_t key, DecodedTexture &decoded);
+    // all the levels of decoded must own their pixels (have a non-zero size)
+    void store(uint64_t key, const DecodedTexture &decoded);
+
+    DecodedTextureDiskCacheStats stats() const;
+
+private:
+    struct Entry {
+        uint64_t key;
+        uint64_t size;
+    };
+
+    fs::path get_path(uint64_t key) const;
+    // must be called with mutex held
+    void evict();
+
+    fs::path folder;
+    uint64_t max_size = DEFAULT_MAX_SIZE;
+
+    mutable std::mutex mutex;
+    // most recently used first
+    std::list<Entry> lru;
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> entries;
+    uint64_t total_size = 0;
+
+    std::atomic<uint64_t> hits{ 0 };
+    std::atomic<uint64_t> misses{ 0 };
+    std::atomic<uint64_t> stores{ 0 };
+    std::atomic<uint64_t> evictions{ 0 };
+    std::atomic<uint32_t> temp_file_idx{ 0 };
+};
+} // namespace renderer
@@ -32,7 +32,7 @@
 #include <map>
 #include <string>
 #include <thread>
-#include <tuple>
+#include <utility>
 #include <vector>
 
 static constexpr auto DEFAULT_RES_WIDTH = 960;
@@ -45,7 +45,8 @@ using UniformBufferSizes = std::array<std::uint32_t, 15>;
 
 namespace renderer {
 
-typedef std::tuple<Sha256Hash, Sha256Hash> ProgramHashes;
+// fragment and vertex program ids given by the program registry
+typedef std::pair<uint32_t, uint32_t> ProgramIds;
 typedef std::vector<std::string> ExcludedUniforms; // vector instead of unordered_set since it's much faster for few elements
 
 // State types
@@ -60,7 +61,9 @@ struct CommandBuffer;
 
 enum class Backend : uint32_t {
     OpenGL,
-    Vulkan
+    Vulkan,
+    // draws nothing, used to measure the cpu emulation speed
+    Null
 };
 
 enum class GXMState : std::uint16_t {
@@ -109,8 +112,9 @@ struct GxmStencilStateValues {
 
 // we hash the first part of this state as a key for the pipeline cache in vulkan
 struct GxmRecordState {
-    Sha256Hash vertex_program_hash;
-    Sha256Hash fragment_program_hash;
+    // first bytes of the program sha256, unlike the program id it is the same on every boot
+    uint64_t vertex_program_hash;
+    uint64_t fragment_program_hash;
 
     SceGxmColorBaseFormat color_base_format;
 
@@ -177,8 +181,8 @@ struct Context {
     int render_finish_status = 0;
     int notification_finish_status = 0;
 
-    Sha256Hash last_draw_fragment_program_hash;
-    Sha256Hash last_draw_vertex_program_hash;
+    uint32_t last_draw_fragment_program_id = UINT32_MAX;
+    uint32_t last_draw_vertex_program_id = UINT32_MAX;
 
     std::map<int, std::vector<uint8_t>> ubo_data;
 
@@ -191,6 +195,8 @@ typedef std::bitset<SCE_GXM_MAX_TEXTURE_UNITS> TextureInfo;
 
 struct ShaderProgram {
     Sha256Hash hash;
+    uint32_t id; // given by the program registry, only valid during this session
+    uint64_t short_hash; // first bytes of hash
     UniformBufferSizes uniform_buffer_sizes; // Size of the buffer in 4-bytes unit
     UniformBufferSizes uniform_buffer_data_offsets; // Offset of the buffer in 4-bytes unit
     size_t max_total_uniform_buffer_storage;
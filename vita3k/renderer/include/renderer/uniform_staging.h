@@ -0,0 +1,58 @@
+// Vita3K emulator project
+// Copyright (C) 2024 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace renderer {
+
+/**
+ * \brief Uniform storage of one shader stage, kept on the cpu between draws.
+ *
+ * The uniform buffers bound for a draw are compared with the ones of the previous draw and the
+ * storage is only uploaded again if one of them changed or if the program uses another size.
+ * Otherwise the previous upload (and its ring buffer offset) can be used for the draw as is.
+ *
+ * Blocks are compared by content rather than with the page write epochs of MemState: games rewrite
+ * their uniform buffers every frame, so tracking these pages would fault on nearly every write while
+ * the comparison is a memcmp of data read for the copy anyway.
+ */
+class UniformStaging {
+public:
+    // copy a uniform buffer at offset (in bytes) in the storage
+    void write(uint32_t offset, const void *data, uint32_t size);
+    // must be called once before each draw using a storage of size bytes
+    // return true if the content must be uploaded for this draw
+    bool needs_upload(uint32_t size);
+    // forget the last upload, the next draw always uploads the storage
+    void invalidate() {
+        dirty = true;
+    }
+
+    const uint8_t *data() const {
+        return content.data();
+    }
+
+private:
+    std::vector<uint8_t> content;
+    uint32_t uploaded_size = 0;
+    bool dirty = true;
+};
+
+} // namespace renderer
@@ -18,9 +18,13 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <condition_variable>
 #include <limits>
 #include <map>
+#include <mutex>
 #include <set>
+#include <unordered_map>
 
 #include <blockingconcurrentqueue.h>
 #include <util/containers.h>
@@ -50,6 +54,57 @@ struct CompileRequest;
 
 using PipelineCompileQueue = moodycamel::BlockingConcurrentQueue<CompileRequest *>;
 
+// parameters given to retrieve_render_pass
+struct RenderPassKey {
+    vk::Format format;
+    uint8_t force_load;
+    uint8_t force_store;
+    uint8_t is_color_transient;
+    uint8_t no_color;
+};
+
+/**
+ * \brief Everything needed to create a pipeline without the gxm programs.
+ *
+ * It is saved along the pipeline cache so that pipelines used during the previous
+ * sessions can be compiled at boot, before the game registers its programs.
+ */
+struct PipelineKey {
+    // a vertex attribute can be a matrix which is split into at most 4 vec4
+    static constexpr size_t MAX_ATTRIBUTES = 16 * 4;
+    static constexpr size_t MAX_BINDINGS = 16;
+
+    Sha256Hash vertex_hash;
+    Sha256Hash fragment_hash;
+    RenderPassKey render_pass;
+    vk::PrimitiveTopology topology;
+    vk::PolygonMode polygon_mode;
+    vk::CullModeFlags cull_mode;
+    vk::CompareOp depth_func;
+    vk::StencilOpState front_stencil;
+    vk::StencilOpState back_stencil;
+    // already takes into account a disabled fragment shader
+    vk::PipelineColorBlendAttachmentState blending;
+    uint8_t depth_write;
+    uint8_t is_fragment_disabled;
+    uint8_t is_frag_color_used;
+    uint8_t vertex_texture_count;
+    uint8_t fragment_texture_count;
+    uint8_t nb_bindings;
+    uint8_t nb_attributes;
+    // only the first nb_bindings and nb_attributes elements are saved
+    std::array<vk::VertexInputBindingDescription, MAX_BINDINGS> bindings;
+    std::array<vk::VertexInputAttributeDescription, MAX_ATTRIBUTES> attributes;
+};
+
+// pipeline compiled at boot from a key saved during a previous session
+struct PrewarmRequest {
+    PipelineKey key;
+    vk::RenderPass render_pass;
+    vk::ShaderModule vertex_shader;
+    vk::ShaderModule fragment_shader;
+};
+
 class PipelineCache {
 friend struct VKState;
 private:
@@ -88,6 +143,19 @@ private:
     // because of multithreading, we want the pointers to remain stable
     unordered_map_stable<Sha256Hash, vk::ShaderModule> shaders;
     unordered_map_stable<uint64_t, vk::Pipeline> pipelines;
+    // the render pass parameters, only accessed by the render thread
+    std::map<vk::RenderPass, RenderPassKey> render_pass_keys;
+
+    // only used when accessing pipeline_keys
+    std::mutex pipeline_keys_mutex;
+    std::unordered_map<uint64_t, PipelineKey> pipeline_keys;
+
+    // pipelines queued by prewarm_pipelines that no compiler thread has started yet
+    std::mutex prewarm_mutex;
+    std::condition_variable prewarm_cond;
+    std::unordered_map<uint64_t, PrewarmRequest> prewarm_pending;
+    // used by the render thread, a draw must not be skipped because its pipeline is still in the prewarm queue
+    void take_prewarmed_pipeline(uint64_t hash, vk::Pipeline &pipeline);
 
     vk::PipelineShaderStageCreateInfo retrieve_shader(const SceGxmProgram *program, const Sha256Hash &hash, bool is_vertex, bool maskupdate, MemState &mem, const shader::Hints &hints);
     vk::PipelineVertexInputStateCreateInfo get_vertex_input_state(const SceGxmVertexProgram &vertex_program, MemState &mem);
@@ -99,7 +167,10 @@ private:
     // each pipeline compiler thread uses this function as its entrypoint
     void compiler_thread(MemState &mem);
 
-    vk::Pipeline compile_pipeline(SceGxmPrimitiveType type, vk::RenderPass render_pass, const SceGxmVertexProgram &vertex_program_gxm, const SceGxmFragmentProgram &fragment_program_gxm, const GxmRecordState &record, const shader::Hints &hints, MemState &mem);
+    vk::Pipeline compile_pipeline(uint64_t hash, SceGxmPrimitiveType type, vk::RenderPass render_pass, const RenderPassKey &render_pass_key, const SceGxmVertexProgram &vertex_program_gxm, const SceGxmFragmentProgram &fragment_program_gxm, const GxmRecordState &record, const shader::Hints &hints, MemState &mem);
+    // return false if the pipeline can't be described by a key
+    bool fill_pipeline_key(PipelineKey &key, SceGxmPrimitiveType type, const RenderPassKey &render_pass_key, const SceGxmVertexProgram &vertex_program_gxm, const SceGxmFragmentProgram &fragment_program_gxm, const GxmRecordState &record, const vk::PipelineVertexInputStateCreateInfo &vertex_input, MemState &mem);
+    vk::Pipeline create_pipeline(const PipelineKey &key, vk::RenderPass render_pass, const vk::PipelineVertexInputStateCreateInfo &vertex_input, vk::ShaderModule vertex_shader, vk::ShaderModule fragment_shader);
 
 public:
     // if not 0, next time the pipeline cache should be saved (in seconds since epoch)
@@ -119,6 +190,10 @@ public:
     // first index is vertex, second is fragment
     vk::PipelineLayout pipeline_layouts[17][17] = {};
 
+    // progress of the pipelines compiled at boot by prewarm_pipelines
+    std::atomic<uint32_t> prewarm_pipelines_total = 0;
+    std::atomic<uint32_t> prewarm_pipelines_done = 0;
+
     PipelineCache(VKState &state);
     void init(bool support_rasterized_order_access);
 
@@ -129,6 +204,9 @@ public:
     vk::Pipeline retrieve_pipeline(VKContext &context, SceGxmPrimitiveType &type, bool consider_for_async, MemState &mem);
 
     vk::ShaderModule precompile_shader(const Sha256Hash &hash, bool search_first = true);
+    // compile in the background the pipelines with a key read from the pipeline cache
+    // must be called after the shaders have been precompiled
+    void prewarm_pipelines();
 
     void set_async_compilation(bool enable);
 };
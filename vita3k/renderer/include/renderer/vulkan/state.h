@@ -25,6 +25,10 @@
 #include <renderer/vulkan/surface_cache.h>
 #include <renderer/vulkan/types.h>
 
+#include <threads/thread_pool.h>
+
+#include <future>
+
 struct Config;
 
 namespace renderer::vulkan {
@@ -69,6 +73,11 @@ struct VKState : public renderer::State {
     vk::Queue general_queue;
     vk::Queue transfer_queue;
 
+    // the scenes are submitted to general_queue by this thread, in the order they were recorded,
+    // so that the render thread can record the next scene while the driver processes the submission
+    ThreadPool submit_thread;
+    std::future<void> last_submission;
+
     // These might be merged into one queue, but for now they are different.
     vk::CommandPool general_command_pool;
     // Transfer pool has transient bit set.
@@ -100,6 +109,10 @@ struct VKState : public renderer::State {
     // support for the VK_KHR_uniform_buffer_standard_layout extension, needed for memory mapping and texture viewport
     bool support_standard_layout = false;
     bool support_rasterized_order_access = false;
+    // support for the VK_KHR_push_descriptor extension, the fragment textures are then pushed instead of using descriptor sets
+    bool support_push_descriptor = false;
+    // maximum number of consecutive draws recorded as a single indirect draw, 1 without the multiDrawIndirect feature
+    uint32_t max_draw_indirect_count = 1;
     
 #ifdef ANDROID
     bool support_android_buffer_import = false;
@@ -113,6 +126,10 @@ struct VKState : public renderer::State {
     void late_init(const Config &cfg, const std::string_view game_id, MemState &mem) override;
     void cleanup();
 
+    void submit_scene(std::vector<vk::CommandBuffer> cmd_buffers, vk::Fence fence);
+    // must be called before using general_queue from the render thread
+    void wait_for_submissions();
+
     TextureCache *get_texture_cache() override {
         return &texture_cache;
     }
@@ -139,6 +156,7 @@ struct VKState : public renderer::State {
     uint32_t get_gpu_version() override;
 
     void precompile_shader(const ShadersHash &hash) override;
+    void prewarm_pipelines() override;
     void preclose_action() override;
     bool support_custom_drivers() override;
     void set_turbo_mode(bool set) override;
@@ -19,10 +19,14 @@
 
 #include <renderer/texture_cache.h>
 #include <renderer/types.h>
+#include <renderer/uniform_staging.h>
 
 #include <threads/queue.h>
 #include <vkutil/objects.h>
 
+#include <array>
+#include <unordered_map>
+
 struct MemState;
 
 namespace renderer::vulkan {
@@ -73,6 +77,7 @@ struct VKTextureCache : public TextureCache {
     void configure_texture(const SceGxmTexture &texture) override;
     void upload_texture_impl(SceGxmTextureBaseFormat base_format, uint32_t width, uint32_t height, uint32_t mip_index, const void *pixels, int face, uint32_t pixels_per_stride) override;
     void upload_done() override;
+    void clear_texture() override;
 
     void configure_sampler(size_t index, const SceGxmTexture &texture, bool no_linear) override;
 
@@ -83,9 +88,22 @@ struct VKTextureCache : public TextureCache {
     }
 };
 
+// content of a texture descriptor set, only the first texture count images are used
+struct TextureDescriptorKey {
+    std::array<vk::DescriptorImageInfo, 16> images = {};
+
+    bool operator==(const TextureDescriptorKey &other) const = default;
+};
+
+struct TextureDescriptorKeyHasher {
+    size_t operator()(const TextureDescriptorKey &key) const;
+};
+
 struct FrameDescriptor {
     std::vector<vk::DescriptorSet> sets;
     int descriptors_idx = 0;
+    // sets written during the frame, they can be bound again by any draw using the same textures
+    std::unordered_map<TextureDescriptorKey, vk::DescriptorSet, TextureDescriptorKeyHasher> written_sets;
 };
 
 struct FrameObject {
@@ -139,8 +157,10 @@ struct TrappedBuffer {
     uint32_t size;
     // used by the index buffer to keep the max index
     uint32_t extra;
-    // no need for it to be atomic
-    bool dirty = false;
+    // pages tracked for writes and their write epoch when the buffer was last copied
+    Address tracked_addr = 0;
+    uint32_t tracked_size = 0;
+    WriteEpoch write_epoch = 0;
     uint8_t* mapped_location;
 
     TrappedBuffer() {}
@@ -228,16 +248,33 @@ struct VKContext : public renderer::Context {
     vkutil::HostRingBuffer fragment_uniform_stream_ring_buffer;
     vkutil::HostRingBuffer vertex_info_uniform_buffer;
     vkutil::HostRingBuffer fragment_info_uniform_buffer;
+    vkutil::HostRingBuffer indirect_draw_ring_buffer;
 
     vk::DescriptorImageInfo vertex_textures[SCE_GXM_MAX_TEXTURE_UNITS] = {};
     vk::DescriptorImageInfo fragment_textures[SCE_GXM_MAX_TEXTURE_UNITS] = {};
 
-    bool vertex_uniform_storage_allocated = false;
-    bool fragment_uniform_storage_allocated = false;
+    // uniform buffers of the next draw, uploaded to the uniform stream ring buffers only when they change
+    UniformStaging vertex_uniform_staging;
+    UniformStaging fragment_uniform_staging;
 
     vk::Buffer vertex_stream_buffers[SCE_GXM_MAX_VERTEX_STREAMS];
     vk::DeviceSize vertex_stream_offsets[SCE_GXM_MAX_VERTEX_STREAMS] = {};
 
+    // bindings last recorded in render_cmd, they are recorded again only when they change
+    vk::PipelineLayout bound_pipeline_layout;
+    std::array<vk::DescriptorSet, 4> bound_descriptor_sets;
+    std::array<uint32_t, 4> bound_dynamic_offsets;
+    vk::Buffer bound_vertex_stream_buffers[SCE_GXM_MAX_VERTEX_STREAMS];
+    vk::DeviceSize bound_vertex_stream_offsets[SCE_GXM_MAX_VERTEX_STREAMS] = {};
+    int bound_vertex_stream_count = 0;
+    vk::Buffer bound_index_buffer;
+    vk::DeviceSize bound_index_offset = 0;
+    vk::IndexType bound_index_type = vk::IndexType::eUint16;
+
+    // draws using the same bindings as the previous one are not recorded right away,
+    // the whole run is recorded as a single indirect draw by flush_pending_draws
+    std::vector<vk::DrawIndexedIndirectCommand> pending_draws;
+
     shader::RenderVertUniformBlock prev_vert_ublock;
     shader::RenderFragUniformBlock prev_frag_ublock;
 
@@ -269,6 +306,8 @@ struct VKContext : public renderer::Context {
     vk::DescriptorSet last_vert_texture_descriptor;
     uint16_t last_frag_texture_count = ~0;
     vk::DescriptorSet last_frag_texture_descriptor;
+    // pipeline layout used for the last push of the fragment textures (with VK_KHR_push_descriptor)
+    vk::PipelineLayout last_frag_push_layout;
 
     VKRenderTarget *render_target = nullptr;
     vk::Viewport viewport;
@@ -324,6 +363,8 @@ struct VKContext : public renderer::Context {
     void start_render_pass(bool create_descriptor_set = true);
     void stop_render_pass();
     void stop_recording(const SceGxmNotification &notif1, const SceGxmNotification &notif2, bool submit = true);
+    // must be called before recording anything else in render_cmd
+    void flush_pending_draws();
 
     // check (when the render target has macroblock set) if we are drawing to another block
     void check_for_macroblock_change(bool is_draw);
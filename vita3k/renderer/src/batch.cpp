@@ -24,6 +24,8 @@
 #include <renderer/vulkan/types.h>
 
 #include <config/state.h>
+#include <algorithm>
+#include <array>
 #include <functional>
 #include <util/log.h>
 #include <util/string_utils.h>
@@ -39,6 +41,18 @@ void generic_command_free(Command *cmd) {
     delete cmd;
 }
 
+void *CommandArena::allocate(std::size_t size, std::size_t alignment) {
+    std::size_t offset = (block_offset + alignment - 1) & ~(alignment - 1);
+    if (offset + size > BLOCK_SIZE) {
+        // allocations bigger than a block get a block of their own
+        blocks.emplace_back(new std::uint8_t[std::max(size, BLOCK_SIZE)]);
+        offset = 0;
+    }
+
+    block_offset = offset + size;
+    return blocks.back().get() + offset;
+}
+
 void complete_command(State &state, CommandHelper &helper, const int code) {
     auto lock = std::unique_lock(state.command_finish_one_mutex);
     helper.complete(code);
@@ -66,31 +80,40 @@ bool wait_cmd(MemState &mem, CommandList &command_list) {
     return renderer::wishlist(sync, timestamp, 500);
 }
 
-void process_batch(renderer::State &state, const FeatureState &features, MemState &mem, Config &config, CommandList &command_list) {
-    using CommandHandlerFunc = decltype(cmd_handle_set_context);
-
-    const static std::map<CommandOpcode, CommandHandlerFunc *> handlers = {
-        { CommandOpcode::SetContext, cmd_handle_set_context },
-        { CommandOpcode::SyncSurfaceData, cmd_handle_sync_surface_data },
-        { CommandOpcode::MidSceneFlush, cmd_handle_mid_scene_flush },
-        { CommandOpcode::CreateContext, cmd_handle_create_context },
-        { CommandOpcode::CreateRenderTarget, cmd_handle_create_render_target },
-        { CommandOpcode::MemoryMap, cmd_handle_memory_map },
-        { CommandOpcode::MemoryUnmap, cmd_handle_memory_unmap },
-        { CommandOpcode::Draw, cmd_handle_draw },
-        { CommandOpcode::TransferCopy, cmd_handle_transfer_copy },
-        { CommandOpcode::TransferDownscale, cmd_handle_transfer_downscale },
-        { CommandOpcode::TransferFill, cmd_handle_transfer_fill },
-        { CommandOpcode::Nop, cmd_handle_nop },
-        { CommandOpcode::SetState, cmd_handle_set_state },
-        { CommandOpcode::SignalSyncObject, cmd_handle_signal_sync_object },
-        { CommandOpcode::WaitSyncObject, cmd_handle_wait_sync_object },
-        { CommandOpcode::SignalNotification, cmd_handle_notification },
-        { CommandOpcode::NewFrame, cmd_new_frame },
-        { CommandOpcode::DestroyRenderTarget, cmd_handle_destroy_render_target },
-        { CommandOpcode::DestroyContext, cmd_handle_destroy_context }
+using CommandHandlerFunc = decltype(cmd_handle_set_context);
+
+// Handlers indexed by opcode
+static constexpr std::array<CommandHandlerFunc *, static_cast<size_t>(CommandOpcode::Count)> make_command_handlers() {
+    std::array<CommandHandlerFunc *, static_cast<size_t>(CommandOpcode::Count)> handlers{};
+    const auto set = [&](CommandOpcode opcode, CommandHandlerFunc *handler) {
+        handlers[static_cast<size_t>(opcode)] = handler;
     };
 
+    set(CommandOpcode::SetContext, cmd_handle_set_context);
+    set(CommandOpcode::SyncSurfaceData, cmd_handle_sync_surface_data);
+    set(CommandOpcode::MidSceneFlush, cmd_handle_mid_scene_flush);
+    set(CommandOpcode::CreateContext, cmd_handle_create_context);
+    set(CommandOpcode::CreateRenderTarget, cmd_handle_create_render_target);
+    set(CommandOpcode::MemoryMap, cmd_handle_memory_map);
+    set(CommandOpcode::MemoryUnmap, cmd_handle_memory_unmap);
+    set(CommandOpcode::Draw, cmd_handle_draw);
+    set(CommandOpcode::TransferCopy, cmd_handle_transfer_copy);
+    set(CommandOpcode::TransferDownscale, cmd_handle_transfer_downscale);
+    set(CommandOpcode::TransferFill, cmd_handle_transfer_fill);
+    set(CommandOpcode::Nop, cmd_handle_nop);
+    set(CommandOpcode::SetState, cmd_handle_set_state);
+    set(CommandOpcode::SignalSyncObject, cmd_handle_signal_sync_object);
+    set(CommandOpcode::WaitSyncObject, cmd_handle_wait_sync_object);
+    set(CommandOpcode::SignalNotification, cmd_handle_notification);
+    set(CommandOpcode::NewFrame, cmd_new_frame);
+    set(CommandOpcode::DestroyRenderTarget, cmd_handle_destroy_render_target);
+    set(CommandOpcode::DestroyContext, cmd_handle_destroy_context);
+    return handlers;
+}
+
+static constexpr auto command_handlers = make_command_handlers();
+
+void process_batch(renderer::State &state, const FeatureState &features, MemState &mem, Config &config, CommandList &command_list) {
     Command *cmd = command_list.first;
 
     // Take a batch, and execute it. Hope it's not too large
@@ -99,12 +122,12 @@ void process_batch(renderer::State &state, const FeatureState &features, MemStat
             break;
         }
 
-        auto handler = handlers.find(cmd->opcode);
-        if (handler == handlers.end()) {
+        CommandHandlerFunc *handler = cmd->opcode < CommandOpcode::Count ? command_handlers[static_cast<size_t>(cmd->opcode)] : nullptr;
+        if (!handler) {
             LOG_ERROR("Unimplemented command opcode {}", static_cast<int>(cmd->opcode));
         } else {
             CommandHelper helper(cmd);
-            handler->second(state, mem, config, helper, features, command_list.context);
+            handler(state, mem, config, helper, features, command_list.context);
         }
 
         Command *last_cmd = cmd;
@@ -124,7 +147,7 @@ void process_batches(renderer::State &state, const FeatureState &features, MemSt
 
     while (!state.should_display) {
         // Try to wait for a batch (about 2 or 3ms, game should be fast for this)
-        auto cmd_list = state.command_buffer_queue.top(3);
+        CommandList *cmd_list = state.command_buffer_queue.top(std::chrono::milliseconds(3));
 
         if (!cmd_list || !is_cmd_ready(mem, *cmd_list)) {
             // beginning of the game or homebrew not using gxm
@@ -146,8 +169,9 @@ void process_batches(renderer::State &state, const FeatureState &features, MemSt
             }
         }
 
-        state.command_buffer_queue.pop();
+        // The list is used in place, release its slot only once it has been processed
         process_batch(state, features, mem, config, *cmd_list);
+        state.command_buffer_queue.pop();
     }
 }
 
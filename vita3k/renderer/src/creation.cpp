@@ -23,6 +23,7 @@
 #include <renderer/types.h>
 
 #include <renderer/gl/functions.h>
+#include <renderer/null/state.h>
 #include <renderer/vulkan/functions.h>
 #include <renderer/vulkan/state.h>
 
@@ -68,6 +69,12 @@ COMMAND(handle_create_context) {
         break;
     }
 
+    case Backend::Null: {
+        *ctx = std::make_unique<Context>();
+        result = true;
+        break;
+    }
+
     default: {
         REPORT_MISSING(renderer.current_backend);
         break;
@@ -111,6 +118,11 @@ COMMAND(handle_create_render_target) {
         result = vulkan::create(dynamic_cast<vulkan::VKState &>(renderer), *render_target, *params, features);
         break;
 
+    case Backend::Null:
+        *render_target = std::make_unique<RenderTarget>();
+        result = true;
+        break;
+
     default:
         REPORT_MISSING(renderer.current_backend);
         break;
@@ -136,6 +148,7 @@ COMMAND(handle_destroy_render_target) {
 
     switch (renderer.current_backend) {
     case Backend::OpenGL:
+    case Backend::Null:
         // nothing to do
         break;
 
@@ -177,8 +190,14 @@ COMMAND(handle_memory_unmap) {
     complete_command(renderer, helper, 0);
 }
 
+static void set_program_identity(ShaderProgram &shader_program, State &state, uint32_t program_id) {
+    shader_program.id = program_id;
+    shader_program.hash = state.program_registry.get_hash(program_id);
+    memcpy(&shader_program.short_hash, shader_program.hash.data(), sizeof(shader_program.short_hash));
+}
+
 // Client
-bool create(std::unique_ptr<FragmentProgram> &fp, State &state, const SceGxmProgram &program, const SceGxmBlendInfo *blend, GXPPtrMap &gxp_ptr_map) {
+bool create(std::unique_ptr<FragmentProgram> &fp, State &state, const SceGxmProgram &program, uint32_t program_id, const SceGxmBlendInfo *blend, GXPPtrMap &gxp_ptr_map) {
     switch (state.current_backend) {
     case Backend::OpenGL:
         gl::create(fp, dynamic_cast<gl::GLState &>(state), program, blend);
@@ -188,13 +207,17 @@ bool create(std::unique_ptr<FragmentProgram> &fp, State &state, const SceGxmProg
         vulkan::create(fp, dynamic_cast<vulkan::VKState &>(state), program, blend);
         break;
 
+    case Backend::Null:
+        fp = std::make_unique<FragmentProgram>();
+        break;
+
     default:
         REPORT_MISSING(state.current_backend);
         return false;
     }
 
-    // Try to hash this shader
-    fp->hash = sha256(&program, program.size);
+    // The program was hashed when it was registered
+    set_program_identity(*fp, state, program_id);
     gxp_ptr_map.emplace(fp->hash, &program);
 
     fp->buffer_count = shader::usse::get_uniform_buffer_sizes(program, fp->uniform_buffer_sizes);
@@ -205,7 +228,7 @@ bool create(std::unique_ptr<FragmentProgram> &fp, State &state, const SceGxmProg
     return true;
 }
 
-bool create(std::unique_ptr<VertexProgram> &vp, State &state, const SceGxmProgram &program, GXPPtrMap &gxp_ptr_map, const std::vector<SceGxmVertexAttribute> &attributes) {
+bool create(std::unique_ptr<VertexProgram> &vp, State &state, const SceGxmProgram &program, uint32_t program_id, GXPPtrMap &gxp_ptr_map, const std::vector<SceGxmVertexAttribute> &attributes) {
     switch (state.current_backend) {
     case Backend::OpenGL:
         gl::create(vp, dynamic_cast<gl::GLState &>(state), program);
@@ -215,13 +238,17 @@ bool create(std::unique_ptr<VertexProgram> &vp, State &state, const SceGxmProgra
         vulkan::create(vp, dynamic_cast<vulkan::VKState &>(state), program);
         break;
 
+    case Backend::Null:
+        vp = std::make_unique<VertexProgram>();
+        break;
+
     default:
         REPORT_MISSING(state.current_backend);
         return false;
     }
 
-    // Hash this shader
-    vp->hash = sha256(&program, program.size);
+    // The program was hashed when it was registered
+    set_program_identity(*vp, state, program_id);
     gxp_ptr_map.emplace(vp->hash, &program);
 
     vp->buffer_count = shader::usse::get_uniform_buffer_sizes(program, vp->uniform_buffer_sizes);
@@ -269,6 +296,13 @@ bool init(SDL_Window *window, std::unique_ptr<State> &state, Backend backend, co
             return false;
         break;
 
+    case Backend::Null:
+        state = std::make_unique<null::NullState>();
+        state->init_paths(root_paths);
+        if (!state->init())
+            return false;
+        break;
+
     default:
         LOG_ERROR("Cannot create a renderer with unsupported backend {}.", static_cast<int>(backend));
         return false;
@@ -276,9 +310,6 @@ bool init(SDL_Window *window, std::unique_ptr<State> &state, Backend backend, co
 
     state->current_backend = backend;
 
-    // Can change this
-    state->command_buffer_queue.maxPendingCount_ = 30;
-
     return true;
 }
 } // namespace renderer
@@ -20,6 +20,7 @@
 #include <renderer/types.h>
 
 #include <renderer/gl/functions.h>
+#include <renderer/gl/state.h>
 #include <renderer/gl/types.h>
 
 #include <gxm/types.h>
@@ -28,23 +29,30 @@
 #include <shader/spirv_recompiler.h>
 
 #include <gxm/functions.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <string_view>
 #include <vector>
 
 namespace renderer::gl {
-static SharedGLObject compile_glsl(GLenum type, const std::string &source) {
-    R_PROFILE(__func__);
 
-    const SharedGLObject shader = std::make_shared<GLObject>();
-    if (!shader->init(glCreateShader(type), glDeleteShader)) {
-        return SharedGLObject();
-    }
+// from GL_KHR_parallel_shader_compile, which is not part of the glad loader
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
 
-    const GLchar *source_glchar = static_cast<const GLchar *>(source.c_str());
-    const GLint length = static_cast<GLint>(source.length());
-    glShaderSource(shader->get(), 1, &source_glchar, &length);
+// not a shader::Target, only used to store program binaries in the shader pack
+static constexpr uint32_t program_binary_target = 0x100;
 
-    glCompileShader(shader->get());
+struct ProgramBinaryHeader {
+    GLenum format;
+    // followed by the name of the driver which created the binary
+    uint32_t driver_size;
+};
 
+static bool check_shader(const SharedGLObject &shader) {
     GLint log_length = 0;
     glGetShaderiv(shader->get(), GL_INFO_LOG_LENGTH, &log_length);
 
@@ -60,14 +68,32 @@ static SharedGLObject compile_glsl(GLenum type, const std::string &source) {
     GLint is_compiled = GL_FALSE;
     glGetShaderiv(shader->get(), GL_COMPILE_STATUS, &is_compiled);
     assert(is_compiled != GL_FALSE);
-    if (!is_compiled) {
+    return is_compiled != GL_FALSE;
+}
+
+// if wait is false, the shader is compiled in the background and checked when the program is linked
+static SharedGLObject compile_glsl(GLenum type, const std::string &source, bool wait = true) {
+    R_PROFILE(__func__);
+
+    const SharedGLObject shader = std::make_shared<GLObject>();
+    if (!shader->init(glCreateShader(type), glDeleteShader)) {
+        return SharedGLObject();
+    }
+
+    const GLchar *source_glchar = static_cast<const GLchar *>(source.c_str());
+    const GLint length = static_cast<GLint>(source.length());
+    glShaderSource(shader->get(), 1, &source_glchar, &length);
+
+    glCompileShader(shader->get());
+
+    if (wait && !check_shader(shader)) {
         return SharedGLObject();
     }
 
     return shader;
 }
 
-static SharedGLObject compile_spirv(GLenum type, const std::vector<std::uint32_t> &source) {
+static SharedGLObject compile_spirv(GLenum type, const std::vector<std::uint32_t> &source, bool wait = true) {
     R_PROFILE(__func__);
 
     const SharedGLObject shader = std::make_shared<GLObject>();
@@ -84,22 +110,7 @@ static SharedGLObject compile_spirv(GLenum type, const std::vector<std::uint32_t
     glShaderBinary(1, need_compile, GL_SHADER_BINARY_FORMAT_SPIR_V_ARB, source_glchar, length);
     glSpecializeShaderARB(need_compile[0], shader_entry, 0, nullptr, nullptr);
 
-    GLint log_length = 0;
-    glGetShaderiv(shader->get(), GL_INFO_LOG_LENGTH, &log_length);
-
-    // Intel driver returns an info log length of at least 1 even if it is empty.
-    if (log_length > 1) {
-        std::vector<GLchar> log;
-        log.resize(log_length);
-        glGetShaderInfoLog(shader->get(), log_length, nullptr, log.data());
-
-        LOG_ERROR("{}", log.data());
-    }
-
-    GLint is_compiled = GL_FALSE;
-    glGetShaderiv(shader->get(), GL_COMPILE_STATUS, &is_compiled);
-    assert(is_compiled != GL_FALSE);
-    if (!is_compiled) {
+    if (wait && !check_shader(shader)) {
         return SharedGLObject();
     }
 
@@ -116,16 +127,102 @@ static std::string convert_hash_to_hex(const Sha256Hash &hash) {
     return ss.str();
 }
 
-static SharedGLObject compile_program(ProgramCache &program_cache, const SharedGLObject frag_shader, const SharedGLObject vert_shader, const ProgramHashes &hashes) {
+static Sha256Hash get_program_binary_key(const Sha256Hash &frag_hash, const Sha256Hash &vert_hash, bool spirv) {
+    std::array<uint8_t, 2 * sizeof(Sha256Hash) + 1> data;
+    memcpy(data.data(), frag_hash.data(), sizeof(Sha256Hash));
+    memcpy(data.data() + sizeof(Sha256Hash), vert_hash.data(), sizeof(Sha256Hash));
+    data.back() = spirv;
+
+    return sha256(data.data(), data.size());
+}
+
+static SharedGLObject load_program_binary(GLState &renderer, const Sha256Hash &key) {
+    if (renderer.program_binary_driver.empty())
+        return SharedGLObject();
+
+    const std::vector<uint8_t> binary = renderer.shader_pack.load_binary(key, program_binary_target);
+    if (binary.size() < sizeof(ProgramBinaryHeader))
+        return SharedGLObject();
+
+    ProgramBinaryHeader header;
+    memcpy(&header, binary.data(), sizeof(header));
+    // a truncated or corrupted entry, it will be replaced once the program is compiled
+    if (header.driver_size >= binary.size() - sizeof(header))
+        return SharedGLObject();
+
+    const std::string_view driver(reinterpret_cast<const char *>(binary.data()) + sizeof(header), header.driver_size);
+    if (driver != renderer.program_binary_driver)
+        // created by another driver, it will be replaced once the program is compiled
+        return SharedGLObject();
+
+    const SharedGLObject program = std::make_shared<GLObject>();
+    if (!program->init(glCreateProgram(), glDeleteProgram)) {
+        return SharedGLObject();
+    }
+
+    const size_t binary_offset = sizeof(header) + header.driver_size;
+    glProgramBinary(program->get(), header.format, binary.data() + binary_offset, static_cast<GLsizei>(binary.size() - binary_offset));
+
+    GLint is_linked = GL_FALSE;
+    glGetProgramiv(program->get(), GL_LINK_STATUS, &is_linked);
+    if (is_linked == GL_FALSE) {
+        return SharedGLObject();
+    }
+
+    return program;
+}
+
+static void store_program_binary(GLState &renderer, const SharedGLObject &program, const Sha256Hash &key) {
+    if (renderer.program_binary_driver.empty())
+        return;
+
+    GLint binary_length = 0;
+    glGetProgramiv(program->get(), GL_PROGRAM_BINARY_LENGTH, &binary_length);
+    if (binary_length <= 0)
+        return;
+
+    ProgramBinaryHeader header{
+        .format = 0,
+        .driver_size = static_cast<uint32_t>(renderer.program_binary_driver.size())
+    };
+    const size_t binary_offset = sizeof(header) + header.driver_size;
+    std::vector<uint8_t> binary(binary_offset + binary_length);
+
+    GLsizei written_length = 0;
+    glGetProgramBinary(program->get(), binary_length, &written_length, &header.format, binary.data() + binary_offset);
+    if (written_length <= 0)
+        return;
+
+    memcpy(binary.data(), &header, sizeof(header));
+    memcpy(binary.data() + sizeof(header), renderer.program_binary_driver.data(), header.driver_size);
+    renderer.shader_pack.store(key, program_binary_target, binary.data(), binary_offset + written_length);
+}
+
+// the link is done in the background if the driver supports parallel shader compile
+static SharedGLObject link_program(GLState &renderer, const SharedGLObject &frag_shader, const SharedGLObject &vert_shader) {
     const SharedGLObject program = std::make_shared<GLObject>();
     if (!program->init(glCreateProgram(), glDeleteProgram)) {
         return SharedGLObject();
     }
 
+    if (!renderer.program_binary_driver.empty())
+        glProgramParameteri(program->get(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
     glAttachShader(program->get(), frag_shader->get());
     glAttachShader(program->get(), vert_shader->get());
     glLinkProgram(program->get());
 
+    return program;
+}
+
+static bool is_program_ready(const SharedGLObject &program) {
+    GLint is_completed = GL_FALSE;
+    glGetProgramiv(program->get(), GL_COMPLETION_STATUS_KHR, &is_completed);
+    return is_completed != GL_FALSE;
+}
+
+// wait for the link to be done and put the program in the cache
+static SharedGLObject finish_program(GLState &renderer, const SharedGLObject &program, const SharedGLObject &frag_shader, const SharedGLObject &vert_shader, const ProgramIds &ids, const Sha256Hash &binary_key) {
     GLint log_length = 0;
     glGetProgramiv(program->get(), GL_INFO_LOG_LENGTH, &log_length);
 
@@ -142,24 +239,25 @@ static SharedGLObject compile_program(ProgramCache &program_cache, const SharedG
     glGetProgramiv(program->get(), GL_LINK_STATUS, &is_linked);
     assert(is_linked != GL_FALSE);
     if (is_linked == GL_FALSE) {
+        // the shaders were not checked if they were compiled in the background
+        check_shader(frag_shader);
+        check_shader(vert_shader);
         return SharedGLObject();
     }
 
     glDetachShader(program->get(), frag_shader->get());
     glDetachShader(program->get(), vert_shader->get());
 
-    program_cache.emplace(hashes, program);
+    store_program_binary(renderer, program, binary_key);
+    renderer.program_cache.emplace(ids, program);
 
     return program;
 }
 
-static SharedGLObject compile_shader(const fs::path &shader_cache_path, const std::string &shader_version, const std::string &hash_hex,
+static SharedGLObject compile_shader(ShaderPack &shader_pack, const std::string &hash_hex,
     const char *type_str, const GLenum type, ShaderCache &cache, const Sha256Hash &hash) {
-    // Set Shader version with hash
-
     // Load Shader
-    const auto shader_name = shader_cache_path / fmt::format("{}-{}.{}", shader_version, hash_hex, type_str);
-    const std::string shader = pre_load_shader_glsl(shader_name);
+    const std::string shader = shader_pack.load_glsl(hash, static_cast<uint32_t>(shader::Target::GLSLOpenGL));
     if (shader.empty()) {
         LOG_WARN("{} shader is empty or not found:\n{}", type_str, hash_hex);
         return SharedGLObject();
@@ -188,10 +286,24 @@ static std::vector<ShadersHash>::iterator get_shaders_hash_index(std::vector<Sha
 }
 
 void pre_compile_program(GLState &renderer, const ShadersHash &hash) {
-    if (fs::exists(renderer.shaders_path) && !fs::is_empty(renderer.shaders_path)) {
+    if (renderer.shader_pack.size() > 0) {
+        // the programs of the application will get the same ids when they are registered
+        const ProgramIds ids(renderer.program_registry.get_id(hash.frag), renderer.program_registry.get_id(hash.vert));
+        // the shaders from the pack are always glsl
+        const Sha256Hash binary_key = get_program_binary_key(hash.frag, hash.vert, false);
+
+        // a program binary skips both shader compilations and the link
+        const SharedGLObject binary_program = load_program_binary(renderer, binary_key);
+        if (binary_program) {
+            renderer.program_cache.emplace(ids, binary_program);
+            renderer.programs_count_pre_compiled++;
+            LOG_INFO("Program Loaded {}/{}", renderer.programs_count_pre_compiled, renderer.shaders_cache_hashs.size());
+            return;
+        }
+
         // Compile Fragment Shader
         const auto frag_hash_hex = convert_hash_to_hex(hash.frag);
-        const SharedGLObject frag_shader = compile_shader(renderer.shaders_path, renderer.shader_version,
+        const SharedGLObject frag_shader = compile_shader(renderer.shader_pack,
             frag_hash_hex, "frag", GL_FRAGMENT_SHADER, renderer.fragment_shader_cache, hash.frag);
         if (!frag_shader) {
             return;
@@ -199,31 +311,32 @@ void pre_compile_program(GLState &renderer, const ShadersHash &hash) {
 
         // Compile Vertex Shader
         const auto vert_hash_hex = convert_hash_to_hex(hash.vert);
-        const SharedGLObject vert_shader = compile_shader(renderer.shaders_path, renderer.shader_version,
+        const SharedGLObject vert_shader = compile_shader(renderer.shader_pack,
             vert_hash_hex, "vert", GL_VERTEX_SHADER, renderer.vertex_shader_cache, hash.vert);
         if (!vert_shader) {
             return;
         }
 
         // Compile Program
-        const ProgramHashes hashes(hash.frag, hash.vert);
-        compile_program(renderer.program_cache, frag_shader, vert_shader, hashes);
+        const SharedGLObject program = link_program(renderer, frag_shader, vert_shader);
+        if (program)
+            finish_program(renderer, program, frag_shader, vert_shader, ids, binary_key);
         renderer.programs_count_pre_compiled++;
         LOG_INFO("Program Compiled {}/{}", renderer.programs_count_pre_compiled, renderer.shaders_cache_hashs.size());
     }
 }
 
 static SharedGLObject get_or_compile_shader(const SceGxmProgram *program, const FeatureState &features, const Sha256Hash &hash,
-    ShaderCache &cache, const GLenum type, const shader::Hints &hints, bool shader_cache, bool spirv, bool maskupdate, const fs::path &shader_cache_path, const fs::path &shader_log_path, const std::string &shader_version, uint32_t &shaders_count_compiled) {
+    ShaderCache &cache, const GLenum type, const shader::Hints &hints, bool shader_cache, bool spirv, bool maskupdate, bool wait, ShaderPack &shader_pack, const fs::path &shader_log_path, const std::string &shader_version, uint32_t &shaders_count_compiled) {
     const auto cached = cache.find(hash);
     if (cached == cache.end()) {
         SharedGLObject obj = nullptr;
 
         // Need to compile new one and add it to cache
         if (features.spirv_shader && spirv) {
-            obj = compile_spirv(type, load_spirv_shader(*program, features, false, hints, maskupdate, shader_cache_path, shader_log_path, shader_version + "spv", shader_cache));
+            obj = compile_spirv(type, load_spirv_shader(*program, hash, features, false, hints, maskupdate, shader_pack, shader_log_path, shader_version + "spv", shader_cache), wait);
         } else {
-            obj = compile_glsl(type, load_glsl_shader(*program, features, hints, maskupdate, shader_cache_path, shader_log_path, shader_version, shader_cache));
+            obj = compile_glsl(type, load_glsl_shader(*program, hash, features, hints, maskupdate, shader_pack, shader_log_path, shader_version, shader_cache), wait);
         }
 
         cache.emplace(hash, obj);
@@ -237,8 +350,9 @@ static SharedGLObject get_or_compile_shader(const SceGxmProgram *program, const
 }
 
 SharedGLObject compile_program(GLState &renderer, GLContext &context, const GxmRecordState &state, const FeatureState &features, const MemState &mem,
-    bool shader_cache, bool spirv, bool maskupdate) {
+    bool shader_cache, bool spirv, bool maskupdate, bool consider_for_async, bool &is_compiling) {
     R_PROFILE(__func__);
+    is_compiling = false;
 
     assert(state.fragment_program);
     assert(state.vertex_program);
@@ -252,14 +366,38 @@ SharedGLObject compile_program(GLState &renderer, GLContext &context, const GxmR
     const GLVertexProgram &vertex_program = *reinterpret_cast<GLVertexProgram *>(
         vertex_program_gxm.renderer_data.get());
 
-    const ProgramHashes hashes(fragment_program.hash, vertex_program.hash);
+    const ProgramIds ids(fragment_program.id, vertex_program.id);
 
     // First pass, trying to find the program, since link is costly
-    const ProgramCache::const_iterator cached = renderer.program_cache.find(hashes);
+    const ProgramCache::const_iterator cached = renderer.program_cache.find(ids);
     if (cached != renderer.program_cache.end()) {
         return cached->second;
     }
 
+    // same as the vulkan renderer, draws which can't be skipped wait for the program
+    const bool compile_async = consider_for_async && renderer.use_async_compilation;
+
+    const PendingProgramCache::iterator pending = renderer.pending_programs.find(ids);
+    if (pending != renderer.pending_programs.end()) {
+        if (compile_async && !is_program_ready(pending->second.program)) {
+            is_compiling = true;
+            return SharedGLObject();
+        }
+
+        const PendingProgram pending_program = std::move(pending->second);
+        renderer.pending_programs.erase(pending);
+        return finish_program(renderer, pending_program.program, pending_program.fragment_shader, pending_program.vertex_shader, ids, pending_program.binary_key);
+    }
+
+    const Sha256Hash binary_key = get_program_binary_key(fragment_program.hash, vertex_program.hash, features.spirv_shader && spirv);
+    if (shader_cache) {
+        const SharedGLObject binary_program = load_program_binary(renderer, binary_key);
+        if (binary_program) {
+            renderer.program_cache.emplace(ids, binary_program);
+            return binary_program;
+        }
+    }
+
     // No... It doesn't exist. Now we try to find each object. If it doesn't exist then we can kind
     // of compile it again.
 
@@ -268,7 +406,7 @@ SharedGLObject compile_program(GLState &renderer, GLContext &context, const GxmR
     context.shader_hints.attributes = &vertex_program_gxm.attributes;
 
     const SharedGLObject fragment_shader = get_or_compile_shader(fragment_program_gxm.program.get(mem), features, fragment_program.hash, renderer.fragment_shader_cache,
-        GL_FRAGMENT_SHADER, context.shader_hints, shader_cache, spirv, maskupdate, renderer.shaders_path, renderer.shaders_log_path, renderer.shader_version, renderer.shaders_count_compiled);
+        GL_FRAGMENT_SHADER, context.shader_hints, shader_cache, spirv, maskupdate, !compile_async, renderer.shader_pack, renderer.shaders_log_path, renderer.shader_version, renderer.shaders_count_compiled);
 
     if (!fragment_shader) {
         LOG_CRITICAL("Error in get/compile fragment vertex shader:\n{}", hex_string(fragment_program.hash));
@@ -276,14 +414,24 @@ SharedGLObject compile_program(GLState &renderer, GLContext &context, const GxmR
     }
 
     const SharedGLObject vertex_shader = get_or_compile_shader(vertex_program_gxm.program.get(mem), features, vertex_program.hash, renderer.vertex_shader_cache,
-        GL_VERTEX_SHADER, context.shader_hints, shader_cache, spirv, maskupdate, renderer.shaders_path, renderer.shaders_log_path, renderer.shader_version, renderer.shaders_count_compiled);
+        GL_VERTEX_SHADER, context.shader_hints, shader_cache, spirv, maskupdate, !compile_async, renderer.shader_pack, renderer.shaders_log_path, renderer.shader_version, renderer.shaders_count_compiled);
 
     if (!vertex_shader) {
         LOG_CRITICAL("Error in get/compiled vertex shader:\n{}", hex_string(vertex_program.hash));
         return SharedGLObject();
     }
 
-    const SharedGLObject program = compile_program(renderer.program_cache, fragment_shader, vertex_shader, hashes);
+    SharedGLObject program = link_program(renderer, fragment_shader, vertex_shader);
+    if (program) {
+        if (compile_async) {
+            // the draws using it are skipped until the driver is done
+            renderer.pending_programs.emplace(ids, PendingProgram{ program, fragment_shader, vertex_shader, binary_key });
+            is_compiling = true;
+            program = SharedGLObject();
+        } else {
+            program = finish_program(renderer, program, fragment_shader, vertex_shader, ids, binary_key);
+        }
+    }
 
     // Save shader cache haches
     const auto shader_cache_hash_index = get_shaders_hash_index(renderer.shaders_cache_hashs, fragment_program.hash, vertex_program.hash);
@@ -76,9 +76,17 @@ void draw(GLState &renderer, GLContext &context, const FeatureState &features, S
 
     // Trying to cache: the last time vs this time shader pair. Does it different somehow?
     // If it's different, we need to switch. Else just stick to it.
-    if (context.record.vertex_program.get(mem)->renderer_data->hash != context.last_draw_vertex_program_hash || context.record.fragment_program.get(mem)->renderer_data->hash != context.last_draw_fragment_program_hash) {
+    if (context.record.vertex_program.get(mem)->renderer_data->id != context.last_draw_vertex_program_id || context.record.fragment_program.get(mem)->renderer_data->id != context.last_draw_fragment_program_id) {
         // Need to recompile!
-        SharedGLObject program = gl::compile_program(renderer, context, context.record, features, mem, config.shader_cache, config.spirv_shader, gxm_fragment_program.is_maskupdate);
+        // We don't want to defer cases where we draw a whole quad over the screen as these draws could be necessary
+        // to be able to see anything
+        const bool can_be_whole_quad = instance_count == 1 && count <= 6;
+        bool is_compiling = false;
+        SharedGLObject program = gl::compile_program(renderer, context, context.record, features, mem, config.shader_cache, config.spirv_shader, gxm_fragment_program.is_maskupdate, !can_be_whole_quad, is_compiling);
+
+        // can happen with asynchronous program compilation, the program is looked for again on the next draw
+        if (is_compiling)
+            return;
 
         LOG_ERROR_IF(!program, "Fail to get program!");
 
@@ -181,6 +189,10 @@ void draw(GLState &renderer, GLContext &context, const FeatureState &features, S
         glBindBufferRange(GL_UNIFORM_BUFFER, 3, context.fragment_info_uniform_buffer.handle(), allocated_buffer.second, sizeof(shader::RenderFragUniformBlock));
     }
 
+    if (!upload_uniform_storage(renderer, context, context.record.vertex_program.get(mem)->renderer_data.get(), true)
+        || !upload_uniform_storage(renderer, context, context.record.fragment_program.get(mem)->renderer_data.get(), false))
+        return;
+
     // Upload vertex stream
     sync_vertex_streams_and_attributes(context, context.record, mem);
 
@@ -240,8 +252,8 @@ void draw(GLState &renderer, GLContext &context, const FeatureState &features, S
         sync_blending(context.record, mem);
     }
 
-    context.last_draw_vertex_program_hash = context.record.vertex_program.get(mem)->renderer_data->hash;
-    context.last_draw_fragment_program_hash = context.record.fragment_program.get(mem)->renderer_data->hash;
+    context.last_draw_vertex_program_id = context.record.vertex_program.get(mem)->renderer_data->id;
+    context.last_draw_fragment_program_id = context.record.fragment_program.get(mem)->renderer_data->id;
 
     context.vertex_stream_ring_buffer.draw_call_done();
     context.index_stream_ring_buffer.draw_call_done();
@@ -249,7 +261,5 @@ void draw(GLState &renderer, GLContext &context, const FeatureState &features, S
     context.fragment_uniform_stream_ring_buffer.draw_call_done();
     context.vertex_info_uniform_buffer.draw_call_done();
     context.fragment_info_uniform_buffer.draw_call_done();
-
-    clear_previous_uniform_storage(context);
 }
 } // namespace renderer::gl
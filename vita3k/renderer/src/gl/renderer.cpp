@@ -234,7 +234,9 @@ bool create(SDL_Window *window, std::unique_ptr<State> &state, const Config &con
         { "GL_EXT_shader_framebuffer_fetch", &gl_state.features.direct_fragcolor },
         { "GL_ARB_gl_spirv", &gl_state.features.spirv_shader },
         { "GL_ARB_get_texture_sub_image", &gl_state.features.support_get_texture_sub_image },
-        { "GL_EXT_shader_image_load_formatted", &gl_state.features.support_unknown_format }
+        { "GL_EXT_shader_image_load_formatted", &gl_state.features.support_unknown_format },
+        { "GL_KHR_parallel_shader_compile", &gl_state.support_parallel_shader_compile },
+        { "GL_ARB_parallel_shader_compile", &gl_state.support_parallel_shader_compile }
     };
 
     for (int i = 0; i < total_extensions; i++) {
@@ -259,6 +261,24 @@ bool create(SDL_Window *window, std::unique_ptr<State> &state, const Config &con
         LOG_WARN("Consider updating your graphics drivers or upgrading your GPU.");
     }
 
+    if (gl_state.support_parallel_shader_compile) {
+        // not part of the glad loader, let the driver use as many threads as it wants
+        typedef void(APIENTRYP PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)(GLuint count);
+        auto max_shader_compiler_threads = reinterpret_cast<PFNGLMAXSHADERCOMPILERTHREADSKHRPROC>(SDL_GL_GetProcAddress("glMaxShaderCompilerThreadsKHR"));
+        if (!max_shader_compiler_threads)
+            max_shader_compiler_threads = reinterpret_cast<PFNGLMAXSHADERCOMPILERTHREADSKHRPROC>(SDL_GL_GetProcAddress("glMaxShaderCompilerThreadsARB"));
+        if (max_shader_compiler_threads)
+            max_shader_compiler_threads(0xFFFFFFFF);
+
+        LOG_INFO("Your GPU supports parallel shader compilation, programs can be compiled asynchronously.");
+    }
+
+    GLint nb_program_binary_formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &nb_program_binary_formats);
+    if (nb_program_binary_formats > 0)
+        // program binaries can only be loaded by the driver that created them
+        gl_state.program_binary_driver = fmt::format("{} {}", gpu_name, reinterpret_cast<const char *>(glGetString(GL_VERSION)));
+
 #ifdef ANDROID
     gl_state.features.use_mask_bit = false;
 #else
@@ -281,6 +301,7 @@ bool GLState::init() {
 
 void GLState::late_init(const Config &cfg, const std::string_view game_id, MemState &mem) {
     texture_cache.init(true, texture_folder(), game_id);
+    texture_cache.decoded_cache.init(cache_path / "textures" / std::string(game_id));
 }
 
 bool create(std::unique_ptr<Context> &context) {
@@ -759,6 +780,10 @@ void GLState::set_anisotropic_filtering(int anisotropic_filtering) {
     texture_cache.anisotropic_filtering = anisotropic_filtering;
 }
 
+void GLState::set_async_compilation(bool enable) {
+    use_async_compilation = enable && support_parallel_shader_compile;
+}
+
 void GLState::precompile_shader(const ShadersHash &hash) {
     pre_compile_program(*this, hash);
 }
@@ -448,13 +448,6 @@ void sync_blending(const GxmRecordState &state, const MemState &mem) {
     }
 }
 
-void clear_previous_uniform_storage(GLContext &context) {
-    context.vertex_uniform_buffer_storage_ptr.first = nullptr;
-    context.vertex_uniform_buffer_storage_ptr.second = 0;
-    context.fragment_uniform_buffer_storage_ptr.first = nullptr;
-    context.fragment_uniform_buffer_storage_ptr.second = 0;
-}
-
 void sync_vertex_streams_and_attributes(GLContext &context, GxmRecordState &state, const MemState &mem) {
     // Vertex attributes.
     const SceGxmVertexProgram &vertex_program = *state.vertex_program.get(mem);
@@ -16,53 +16,55 @@
 // 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
 
 #include <renderer/gl/functions.h>
+#include <renderer/gl/state.h>
 #include <renderer/gl/types.h>
 
 #include <renderer/profile.h>
 #include <renderer/types.h>
 
+#include <util/log.h>
+
 #include <algorithm>
+#include <cstring>
 
 namespace renderer::gl {
-bool set_uniform_buffer(GLContext &context, const ShaderProgram *program, const bool vertex_shader, const int block_num, const int size, const uint8_t *data) {
+void set_uniform_buffer(GLContext &context, const ShaderProgram *program, const bool vertex_shader, const int block_num, const int size, const uint8_t *data) {
     auto offset = program->uniform_buffer_data_offsets.at(block_num);
     if (offset == static_cast<std::uint32_t>(-1)) {
-        return true;
+        return;
     }
 
     const size_t data_size_upload = std::min<size_t>(size, program->uniform_buffer_sizes.at(block_num) * 4);
     const size_t offset_start_upload = offset * 4;
 
-    if (vertex_shader) {
-        if (!context.vertex_uniform_buffer_storage_ptr.first) {
-            // Allocate a region for it. Don't worry though, when the shader program is changed
-            context.vertex_uniform_buffer_storage_ptr = context.vertex_uniform_stream_ring_buffer.allocate(program->max_total_uniform_buffer_storage * 4);
-
-            if (!context.vertex_uniform_buffer_storage_ptr.first) {
-                LOG_ERROR("Unable to allocate vertex SSBO from persistent mapped buffer");
-                return false;
-            }
-
-            glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 0, context.vertex_uniform_stream_ring_buffer.handle(), context.vertex_uniform_buffer_storage_ptr.second, program->max_total_uniform_buffer_storage * 4);
-        }
+    UniformStaging &staging = vertex_shader ? context.vertex_uniform_staging : context.fragment_uniform_staging;
+    staging.write(offset_start_upload, data, data_size_upload);
+}
 
-        std::memcpy(context.vertex_uniform_buffer_storage_ptr.first + offset_start_upload, data, data_size_upload);
-    } else {
-        if (!context.fragment_uniform_buffer_storage_ptr.first) {
-            // Allocate a region for it. Don't worry though, when the shader program is changed
-            context.fragment_uniform_buffer_storage_ptr = context.fragment_uniform_stream_ring_buffer.allocate(program->max_total_uniform_buffer_storage * 4);
+bool upload_uniform_storage(GLState &renderer, GLContext &context, const ShaderProgram *program, const bool vertex_shader) {
+    const size_t storage_size = program->max_total_uniform_buffer_storage * 4;
+    renderer.frame_stats.uniform_bytes_requested += storage_size;
 
-            if (!context.fragment_uniform_buffer_storage_ptr.first) {
-                LOG_ERROR("Unable to allocate fragment SSBO from persistent mapped buffer");
-                return false;
-            }
+    UniformStaging &staging = vertex_shader ? context.vertex_uniform_staging : context.fragment_uniform_staging;
+    RingBuffer &ring_buffer = vertex_shader ? context.vertex_uniform_stream_ring_buffer : context.fragment_uniform_stream_ring_buffer;
+    std::size_t &storage_offset = vertex_shader ? context.vertex_uniform_buffer_storage_offset : context.fragment_uniform_buffer_storage_offset;
 
-            glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 1, context.fragment_uniform_stream_ring_buffer.handle(), context.fragment_uniform_buffer_storage_ptr.second, program->max_total_uniform_buffer_storage * 4);
+    if (staging.needs_upload(storage_size)) {
+        const std::pair<std::uint8_t *, std::size_t> storage_ptr = ring_buffer.allocate(storage_size);
+        if (!storage_ptr.first) {
+            LOG_ERROR("Unable to allocate {} SSBO from persistent mapped buffer", vertex_shader ? "vertex" : "fragment");
+            staging.invalidate();
+            return false;
         }
 
-        std::memcpy(context.fragment_uniform_buffer_storage_ptr.first + offset_start_upload, data, data_size_upload);
+        std::memcpy(storage_ptr.first, staging.data(), storage_size);
+        storage_offset = storage_ptr.second;
+        renderer.frame_stats.uniform_bytes_uploaded += storage_size;
     }
 
+    // the binding is shared with the other gxm contexts, so it is always set again
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, vertex_shader ? 0 : 1, ring_buffer.handle(), storage_offset, storage_size);
+
     return true;
 }
 } // namespace renderer::gl
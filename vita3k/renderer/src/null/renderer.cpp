@@ -0,0 +1,81 @@
+// Vita3K emulator project
+// Copyright (C) 2024 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+
+#include <renderer/null/state.h>
+
+#include <display/state.h>
+#include <mem/state.h>
+#include <shader/spirv_recompiler.h>
+#include <util/log.h>
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+namespace renderer::null {
+
+bool NullState::init() {
+    shader_version = fmt::format("v{}", shader::CURRENT_VERSION);
+
+    LOG_INFO("Using the null renderer, nothing will be drawn.");
+
+    return true;
+}
+
+void NullState::late_init(const Config &cfg, const std::string_view game_id, MemState &mem) {
+    this->mem = &mem;
+}
+
+void NullState::render_frame(const SceFVector2 &viewport_pos, const SceFVector2 &viewport_size, DisplayState &display,
+    const GxmState &gxm, MemState &mem) {
+    has_new_frame = should_display;
+    should_display = false;
+}
+
+void NullState::swap_window(SDL_Window *window) {
+    // nothing is presented, so there is no vsync to slow down the main loop when the game is not rendering
+    if (!has_new_frame)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+std::vector<uint32_t> NullState::dump_frame(DisplayState &display, uint32_t &width, uint32_t &height) {
+    DisplayFrameInfo frame;
+    {
+        std::lock_guard<std::mutex> guard(display.display_info_mutex);
+        frame = display.next_rendered_frame;
+    }
+
+    if (!frame.base || !mem)
+        return {};
+
+    // only what the cpu and the transfers wrote to the framebuffer is there
+    width = frame.image_size.x;
+    height = frame.image_size.y;
+    std::vector<uint32_t> pixels(static_cast<size_t>(width) * height);
+    const uint32_t *src = frame.base.cast<const uint32_t>().get(*mem);
+    for (uint32_t y = 0; y < height; y++)
+        memcpy(&pixels[static_cast<size_t>(y) * width], src + static_cast<size_t>(y) * frame.pitch, width * sizeof(uint32_t));
+
+    return pixels;
+}
+
+int NullState::get_supported_filters() {
+    return static_cast<int>(Filter::NEAREST);
+}
+
+} // namespace renderer::null
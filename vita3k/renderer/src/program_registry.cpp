@@ -0,0 +1,64 @@
+// Vita3K emulator project
+// Copyright (C) 2024 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <renderer/program_registry.h>
+
+#include <gxm/types.h>
+
+#include <xxh3.h>
+
+namespace renderer {
+
+uint32_t ProgramRegistry::register_program(const SceGxmProgram &program) {
+    const XXH128_hash_t content_hash = XXH3_128bits(&program, program.size);
+    const std::pair<uint64_t, uint64_t> content_key = { content_hash.low64, content_hash.high64 };
+
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        auto it = content_ids.find(content_key);
+        if (it != content_ids.end())
+            return it->second;
+    }
+
+    // first time this program is seen, compute its sha256 outside of the lock
+    const Sha256Hash hash = sha256(&program, program.size);
+
+    const std::lock_guard<std::mutex> lock(mutex);
+    const uint32_t id = get_id_locked(hash);
+    content_ids.emplace(content_key, id);
+    return id;
+}
+
+uint32_t ProgramRegistry::get_id(const Sha256Hash &hash) {
+    const std::lock_guard<std::mutex> lock(mutex);
+    return get_id_locked(hash);
+}
+
+uint32_t ProgramRegistry::get_id_locked(const Sha256Hash &hash) {
+    auto [it, inserted] = hash_ids.emplace(hash, static_cast<uint32_t>(hashes.size()));
+    if (inserted)
+        hashes.push_back(hash);
+
+    return it->second;
+}
+
+const Sha256Hash &ProgramRegistry::get_hash(uint32_t id) {
+    const std::lock_guard<std::mutex> lock(mutex);
+    return hashes[id];
+}
+
+} // namespace renderer
@@ -77,6 +77,9 @@ COMMAND(handle_set_context) {
         vulkan::set_context(*reinterpret_cast<vulkan::VKContext *>(render_context), mem, reinterpret_cast<vulkan::VKRenderTarget *>(rt), features);
         break;
 
+    case Backend::Null:
+        break;
+
     default:
         REPORT_MISSING(renderer.current_backend);
         break;
@@ -136,7 +139,8 @@ COMMAND(handle_sync_surface_data) {
     if (renderer.current_backend == Backend::OpenGL && static_cast<int>(renderer.res_multiplier * 4.0f) % 4 != 0)
         renderer.disable_surface_sync = true;
 
-    if (renderer.disable_surface_sync || renderer.current_backend == Backend::Vulkan) {
+    // with the null renderer, the surface in memory already has everything the cpu and the transfers wrote to it
+    if (renderer.disable_surface_sync || renderer.current_backend == Backend::Vulkan || renderer.current_backend == Backend::Null) {
         if (helper.cmd->status) {
             complete_command(renderer, helper, 0);
         }
@@ -228,6 +232,10 @@ COMMAND(handle_draw) {
             count, instance_count, mem, config);
         break;
 
+    case Backend::Null:
+        // nothing is drawn
+        break;
+
     default:
         REPORT_MISSING(renderer.current_backend);
         break;
@@ -0,0 +1,272 @@
+// Vita3K emulator project
+// Copyright (C) 2024 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <renderer/shader_pack.h>
+#include <renderer/texture_disk_cache.h>
+
+#include <shader/spirv_recompiler.h>
+#include <util/align.h>
+#include <util/log.h>
+
+#include <cstring>
+
+namespace renderer {
+
+static constexpr uint32_t shader_pack_magic = 0x4B505356; // VSPK
+static constexpr uint32_t shader_pack_version = 1;
+static constexpr uint32_t shader_entry_magic = 0x59544E45; // ENTY
+
+// don't rewrite the file for a few outdated shaders
+static constexpr uint64_t compact_min_size = 256 * 1024;
+
+struct ShaderPackHeader {
+    uint32_t magic;
+    uint32_t version;
+};
+
+struct ShaderPackEntryHeader {
+    uint32_t magic;
+    uint32_t size;
+    ShaderPackKey key;
+};
+
+// the content of each entry is aligned so that spirv can be read in place
+static constexpr uint64_t shader_entry_alignment = 8;
+
+size_t ShaderPack::KeyHasher::operator()(const ShaderPackKey &key) const {
+    // the program hash is already a sha256
+    uint64_t hash;
+    memcpy(&hash, key.hash.data(), sizeof(hash));
+    return static_cast<size_t>(hash ^ (static_cast<uint64_t>(key.target) << 56) ^ (static_cast<uint64_t>(key.features_mask) * 0x9E3779B97F4A7C15ULL));
+}
+
+ShaderPack::ShaderPack() = default;
+
+ShaderPack::~ShaderPack() = default;
+
+ShaderPackKey ShaderPack::make_key(const Sha256Hash &hash, uint32_t target) const {
+    return ShaderPackKey{
+        .hash = hash,
+        .version = shader::CURRENT_VERSION,
+        .target = target,
+        .features_mask = features_mask,
+        .padding = 0
+    };
+}
+
+void ShaderPack::open(const fs::path &path, uint32_t features_mask) {
+    close();
+
+    boost::system::error_code error;
+    fs::create_directories(path.parent_path(), error);
+
+    const std::unique_lock<std::shared_mutex> lock(mutex);
+    this->path = path;
+    this->features_mask = features_mask;
+
+    const auto read_index = [&]() {
+        // return the size taken by outdated or superseded shaders
+        uint64_t garbage_size = 0;
+        entries.clear();
+        file_size = 0;
+
+        file = std::make_unique<MappedFile>();
+        if (!file->open(path) || file->size() < sizeof(ShaderPackHeader)) {
+            file.reset();
+            return garbage_size;
+        }
+
+        const uint8_t *content = file->data();
+        const ShaderPackHeader *header = reinterpret_cast<const ShaderPackHeader *>(content);
+        if (header->magic != shader_pack_magic || header->version != shader_pack_version) {
+            // it will be overwritten by the next store
+            file.reset();
+            return garbage_size;
+        }
+
+        uint64_t offset = sizeof(ShaderPackHeader);
+        while (offset + sizeof(ShaderPackEntryHeader) <= file->size()) {
+            const ShaderPackEntryHeader *entry = reinterpret_cast<const ShaderPackEntryHeader *>(content + offset);
+            const uint64_t data_offset = offset + sizeof(ShaderPackEntryHeader);
+            if (entry->magic != shader_entry_magic || entry->size > file->size() - data_offset)
+                // the last store was interrupted
+                break;
+
+            const uint64_t entry_size = align(sizeof(ShaderPackEntryHeader) + entry->size, shader_entry_alignment);
+            if (entry->key.version != shader::CURRENT_VERSION) {
+                garbage_size += entry_size;
+            } else {
+                auto [it, inserted] = entries.insert_or_assign(entry->key, Entry{ content + data_offset, entry->size, offset });
+                if (!inserted)
+                    garbage_size += entry_size;
+            }
+
+            offset += entry_size;
+        }
+        file_size = std::min<uint64_t>(offset, file->size());
+
+        return garbage_size;
+    };
+
+    const uint64_t garbage_size = read_index();
+    if (garbage_size >= compact_min_size && garbage_size * 2 > file_size) {
+        compact();
+        read_index();
+    }
+}
+
+void ShaderPack::compact() {
+    const fs::path temp_path = fs::path(path).replace_extension(".tmp");
+    uint64_t new_size = 0;
+    {
+        fs::ofstream temp_file(temp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!temp_file.is_open())
+            return;
+
+        const ShaderPackHeader header{ .magic = shader_pack_magic, .version = shader_pack_version };
+        temp_file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+        constexpr char padding[shader_entry_alignment] = {};
+        for (const auto &[key, entry] : entries) {
+            const uint8_t *entry_header = file->data() + entry.file_offset;
+            const uint64_t entry_size = sizeof(ShaderPackEntryHeader) + entry.size;
+            temp_file.write(reinterpret_cast<const char *>(entry_header), entry_size);
+            temp_file.write(padding, align(entry_size, shader_entry_alignment) - entry_size);
+        }
+
+        if (!temp_file) {
+            temp_file.close();
+            boost::system::error_code error;
+            fs::remove(temp_path, error);
+            return;
+        }
+        new_size = temp_file.tellp();
+    }
+
+    // the file must not be mapped while being replaced
+    entries.clear();
+    file.reset();
+
+    const uint64_t old_size = file_size;
+    boost::system::error_code error;
+    fs::rename(temp_path, path, error);
+    if (error) {
+        fs::remove(temp_path, error);
+        return;
+    }
+
+    LOG_INFO("Shader pack compacted from {} KiB to {} KiB", old_size / 1024, new_size / 1024);
+}
+
+void ShaderPack::close() {
+    const std::unique_lock<std::shared_mutex> lock(mutex);
+    entries.clear();
+    stored_shaders.clear();
+    file.reset();
+    file_size = 0;
+    path.clear();
+}
+
+const ShaderPack::Entry *ShaderPack::find(const ShaderPackKey &key) const {
+    auto it = entries.find(key);
+    if (it == entries.end())
+        return nullptr;
+
+    return &it->second;
+}
+
+std::vector<uint32_t> ShaderPack::load_spirv(const Sha256Hash &hash, uint32_t target) {
+    std::vector<uint32_t> spirv;
+
+    const std::shared_lock<std::shared_mutex> lock(mutex);
+    const Entry *entry = find(make_key(hash, target));
+    if (entry) {
+        spirv.resize((entry->size + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+        memcpy(spirv.data(), entry->data, entry->size);
+    }
+
+    return spirv;
+}
+
+std::string ShaderPack::load_glsl(const Sha256Hash &hash, uint32_t target) {
+    const std::shared_lock<std::shared_mutex> lock(mutex);
+    const Entry *entry = find(make_key(hash, target));
+    if (!entry)
+        return {};
+
+    return std::string(reinterpret_cast<const char *>(entry->data), entry->size);
+}
+
+std::vector<uint8_t> ShaderPack::load_binary(const Sha256Hash &hash, uint32_t target) {
+    const std::shared_lock<std::shared_mutex> lock(mutex);
+    const Entry *entry = find(make_key(hash, target));
+    if (!entry)
+        return {};
+
+    return std::vector<uint8_t>(entry->data, entry->data + entry->size);
+}
+
+void ShaderPack::store(const Sha256Hash &hash, uint32_t target, const void *data, size_t size) {
+    if (size == 0)
+        return;
+
+    // keep a copy so that the shader can be loaded again without mapping the file a second time
+    auto content = std::make_unique<uint8_t[]>(size);
+    memcpy(content.get(), data, size);
+
+    const ShaderPackEntryHeader entry_header{
+        .magic = shader_entry_magic,
+        .size = static_cast<uint32_t>(size),
+        .key = make_key(hash, target)
+    };
+
+    const std::unique_lock<std::shared_mutex> lock(mutex);
+    if (path.empty())
+        return;
+
+    entries.insert_or_assign(entry_header.key, Entry{ content.get(), entry_header.size, file_size });
+    stored_shaders.push_back(std::move(content));
+
+    // the entry is written over a partially written one if there is any
+    const bool is_new_file = file_size == 0;
+    fs::fstream pack_file(path, std::ios::in | std::ios::out | std::ios::binary | (is_new_file ? std::ios::trunc : std::ios::openmode()));
+    if (!pack_file.is_open())
+        return;
+
+    if (is_new_file) {
+        const ShaderPackHeader header{ .magic = shader_pack_magic, .version = shader_pack_version };
+        pack_file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file_size = sizeof(header);
+        entries[entry_header.key].file_offset = file_size;
+    }
+
+    constexpr char padding[shader_entry_alignment] = {};
+    const uint64_t entry_size = sizeof(ShaderPackEntryHeader) + size;
+    pack_file.seekp(file_size);
+    pack_file.write(reinterpret_cast<const char *>(&entry_header), sizeof(entry_header));
+    pack_file.write(reinterpret_cast<const char *>(data), size);
+    pack_file.write(padding, align(entry_size, shader_entry_alignment) - entry_size);
+    if (pack_file)
+        file_size += align(entry_size, shader_entry_alignment);
+}
+
+size_t ShaderPack::size() const {
+    const std::shared_lock<std::shared_mutex> lock(mutex);
+    return entries.size();
+}
+
+} // namespace renderer
@@ -83,7 +83,7 @@ COMMAND_SET_STATE(program) {
     if (is_fragment) {
         render_context->record.fragment_program = program.cast<SceGxmFragmentProgram>();
         const SceGxmFragmentProgram *gxm_program = render_context->record.fragment_program.get(mem);
-        render_context->record.fragment_program_hash = gxm_program->renderer_data->hash;
+        render_context->record.fragment_program_hash = gxm_program->renderer_data->short_hash;
         render_context->record.is_maskupdate = gxm_program->is_maskupdate;
 
         switch (renderer.current_backend) {
@@ -101,7 +101,7 @@ COMMAND_SET_STATE(program) {
     } else {
         render_context->record.vertex_program = program.cast<SceGxmVertexProgram>();
         const SceGxmVertexProgram *gxm_program = render_context->record.vertex_program.get(mem);
-        render_context->record.vertex_program_hash = gxm_program->renderer_data->hash;
+        render_context->record.vertex_program_hash = gxm_program->renderer_data->short_hash;
     }
 
     if (renderer.current_backend == Backend::Vulkan) {
@@ -534,6 +534,10 @@ COMMAND_SET_STATE(visibility_index) {
 
 COMMAND(handle_set_state) {
     // TRACY_FUNC_COMMANDS(handle_set_state); All set state commands have tracy so kinda redundant
+    // nothing is drawn with the null renderer, so the state is never used
+    if (renderer.current_backend == Backend::Null)
+        return;
+
     renderer::GXMState gxm_state_to_set = helper.pop<renderer::GXMState>();
     using StateChangeHandlerFunc = decltype(cmd_set_state_region_clip);
 
@@ -88,6 +88,11 @@ COMMAND(new_frame) {
         renderer.should_display = true;
     }
 
+    renderer.last_frame_stats = renderer.frame_stats;
+    renderer.frame_stats = {};
+
+    renderer.get_texture_cache()->new_frame();
+
     if (renderer.current_backend == Backend::Vulkan) {
         vulkan::new_frame(*reinterpret_cast<vulkan::VKContext *>(renderer.context));
     }
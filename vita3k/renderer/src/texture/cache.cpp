@@ -27,17 +27,16 @@
 #include <util/log.h>
 
 #include <algorithm>
+#include <chrono>
 #include <cstring>
 #include <numeric>
+#include <thread>
 #ifdef __x86_64__
 #include <xxh_x86dispatch.h>
 #else
 #define XXH_INLINE_ALL
 #include <xxhash.h>
 #endif
-#ifdef WIN32
-#include <execution>
-#endif
 
 namespace renderer {
 namespace texture {
@@ -46,19 +45,65 @@ static uint64_t hash_data(const void *data, size_t size) {
     return XXH3_64bits(data, size);
 }
 
+static constexpr size_t HASH_CHUNK_SIZE = 64 * 1024;
+// below this size, waking up the workers costs more than what they save
+static constexpr size_t PARALLEL_HASH_MIN_SIZE = 1024 * 1024;
+
+// hash of the chunk digests, so that the chunks can be hashed independently
+static uint64_t hash_data_chunked(const uint8_t *data, size_t size, ThreadPool *pool) {
+    if (size <= HASH_CHUNK_SIZE)
+        return hash_data(data, size);
+
+    const size_t nb_chunks = (size + HASH_CHUNK_SIZE - 1) / HASH_CHUNK_SIZE;
+    static thread_local std::vector<uint64_t> digests_storage;
+    digests_storage.resize(nb_chunks);
+    // a thread_local can't be captured, the workers must be given the storage of this thread
+    uint64_t *const digests = digests_storage.data();
+
+    const auto hash_chunks = [=](const size_t first_chunk, const size_t last_chunk) {
+        for (size_t chunk = first_chunk; chunk < last_chunk; chunk++) {
+            const size_t offset = chunk * HASH_CHUNK_SIZE;
+            digests[chunk] = hash_data(data + offset, std::min(HASH_CHUNK_SIZE, size - offset));
+        }
+    };
+
+    if (pool && pool->is_running() && size >= PARALLEL_HASH_MIN_SIZE) {
+        // the current thread takes the last share
+        const size_t nb_shares = std::min(pool->size() + 1, nb_chunks);
+        const size_t chunks_per_share = (nb_chunks + nb_shares - 1) / nb_shares;
+
+        std::vector<std::future<void>> jobs;
+        jobs.reserve(nb_shares - 1);
+        size_t first_chunk = 0;
+        for (size_t share = 0; share < nb_shares - 1; share++) {
+            const size_t last_chunk = std::min(first_chunk + chunks_per_share, nb_chunks);
+            jobs.push_back(pool->submit([&hash_chunks, first_chunk, last_chunk] { hash_chunks(first_chunk, last_chunk); }));
+            first_chunk = last_chunk;
+        }
+        hash_chunks(first_chunk, nb_chunks);
+
+        for (auto &job : jobs)
+            job.wait();
+    } else {
+        hash_chunks(0, nb_chunks);
+    }
+
+    return hash_data(digests, nb_chunks * sizeof(uint64_t));
+}
+
 static uint64_t hash_palette_data(const SceGxmTexture &texture, size_t count, const MemState &mem) {
     const uint32_t *const palette_bytes = get_texture_palette(texture, mem);
     return hash_data(palette_bytes, count * sizeof(uint32_t));
 }
 
-uint64_t hash_texture_data(const SceGxmTexture &texture, uint32_t texture_size, const MemState &mem) {
+uint64_t hash_texture_data(const SceGxmTexture &texture, uint32_t texture_size, const MemState &mem, ThreadPool *pool) {
     const SceGxmTextureFormat format = gxm::get_format(texture);
     const SceGxmTextureBaseFormat base_format = gxm::get_base_format(format);
-    const Ptr<const void> data(texture.data_addr << 2);
+    const Ptr<const uint8_t> data(texture.data_addr << 2);
     uint64_t data_hash = 0;
 
     if (data.address()) {
-        data_hash = hash_data(data.get(mem), texture_size);
+        data_hash = hash_data_chunked(data.get(mem), texture_size, pool);
     }
 
     switch (base_format) {
@@ -304,6 +349,8 @@ bool TextureCache::init(const bool hashless_texture_cache, const fs::path &textu
 
     // prevent stutter caused by the hashmap resizing
     texture_lookup.reserve(TextureCacheSize);
+    pending_decodes.resize(TextureCacheSize);
+    hash_pool.start(std::clamp(std::thread::hardware_concurrency() / 4, 1U, 4U));
 
     use_sampler_cache = sampler_cache_size > 0;
     if (use_sampler_cache) {
@@ -323,7 +370,83 @@ bool TextureCache::init(const bool hashless_texture_cache, const fs::path &textu
     return true;
 }
 
-void TextureCache::upload_texture(const SceGxmTexture &gxm_texture, MemState &mem) {
+void TextureCache::set_async_decode(bool enable) {
+    if (enable == async_decode)
+        return;
+
+    async_decode = enable;
+    if (enable) {
+        // the emulated cpu and the render thread are already busy, leave them some room
+        const unsigned int nb_threads = std::clamp(std::thread::hardware_concurrency() / 4, 1U, 4U);
+        LOG_INFO("Enabling asynchronous texture decoding with {} threads", nb_threads);
+        decode_pool.start(nb_threads);
+    } else {
+        LOG_INFO("Asynchronous texture decoding is now disabled");
+        decode_pool.stop();
+
+        // jobs which did not run are lost, upload these textures again
+        for (size_t i = 0; i < pending_decodes.size(); i++) {
+            if (!pending_decodes[i].result.valid())
+                continue;
+
+            pending_decodes[i] = {};
+            TextureCacheInfo &info = texture_queue.items[i].content;
+            info.hash = 0;
+            info.dirty = true;
+        }
+    }
+}
+
+// only worth it for textures the cpu has to convert before uploading them
+bool TextureCache::can_decode_async(const SceGxmTexture &gxm_texture) const {
+    // replacement textures are looked up and exported with the content of the texture
+    if (!async_decode || import_textures || export_textures)
+        return false;
+
+    const SceGxmTextureBaseFormat base_format = gxm::get_base_format(gxm::get_format(gxm_texture));
+    if (gxm::is_bcn_format(base_format))
+        // placeholders are cleared, which can't be done on compressed images
+        return !support_dxt;
+
+    const auto texture_type = gxm_texture.texture_type();
+    if (texture_type != SCE_GXM_TEXTURE_LINEAR && texture_type != SCE_GXM_TEXTURE_LINEAR_STRIDED)
+        return true;
+
+    switch (base_format) {
+    case SCE_GXM_TEXTURE_BASE_FORMAT_P4:
+    case SCE_GXM_TEXTURE_BASE_FORMAT_P8:
+    case SCE_GXM_TEXTURE_BASE_FORMAT_PVRT2BPP:
+    case SCE_GXM_TEXTURE_BASE_FORMAT_PVRT4BPP:
+    case SCE_GXM_TEXTURE_BASE_FORMAT_PVRTII2BPP:
+    case SCE_GXM_TEXTURE_BASE_FORMAT_PVRTII4BPP:
+    case SCE_GXM_TEXTURE_BASE_FORMAT_YUV420P2:
+    case SCE_GXM_TEXTURE_BASE_FORMAT_YUV420P3:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool TextureCache::upload_pending_decode(TextureCacheInfo &info) {
+    PendingTextureDecode &pending = pending_decodes[info.index];
+    if (pending.result.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return false;
+
+    const DecodedTexture decoded = pending.result.get();
+    upload_decoded_texture(decoded);
+    upload_done();
+
+    if (pending.stale) {
+        // the texture changed during the decode, this will make the next bind decode it again
+        info.hash = 0;
+        info.dirty = true;
+    }
+    pending = {};
+
+    return true;
+}
+
+void TextureCache::convert_texture(const SceGxmTexture &gxm_texture, const MemState &mem, DecodedTexture &decoded) const {
     R_PROFILE(__func__);
 
     bool is_vulkan = (backend == renderer::Backend::Vulkan);
@@ -339,8 +462,8 @@ void TextureCache::upload_texture(const SceGxmTexture &gxm_texture, MemState &me
     uint32_t width = gxm::get_width(gxm_texture);
     uint32_t height = gxm::get_height(gxm_texture);
 
-    const Ptr<uint8_t> data(gxm_texture.data_addr << 2);
-    uint8_t *texture_data = data.get(mem);
+    const Ptr<const uint8_t> data(gxm_texture.data_addr << 2);
+    const uint8_t *texture_data = data.get(mem);
 
     if (!texture_data) {
         return;
@@ -561,9 +684,16 @@ void TextureCache::upload_texture(const SceGxmTexture &gxm_texture, MemState &me
             upload_format = get_matching_decompressed_format(base_format);
         }
 
-        upload_texture_impl(upload_format, width, height, mip_index, pixels, upload_type, pixels_per_stride);
-        if (export_textures)
-            export_texture_impl(upload_format, width, height, mip_index, pixels, upload_type, pixels_per_stride);
+        // the level keeps the buffer it was converted into, the next one starts from an empty buffer
+        size_t converted_size = 0;
+        if (pixels == texture_data_decompressed.data()) {
+            converted_size = texture_data_decompressed.size();
+            decoded.buffers.push_back(std::move(texture_data_decompressed));
+        } else if (pixels == texture_pixels_lineared.data()) {
+            converted_size = texture_pixels_lineared.size();
+            decoded.buffers.push_back(std::move(texture_pixels_lineared));
+        }
+        decoded.levels.push_back({ upload_format, width, height, mip_index, upload_type, pixels_per_stride, pixels, converted_size });
 
         const uint32_t nb_pixels = align(layout_width, align_width) * align(layout_height, align_height);
         const uint32_t mip_size = (nb_pixels >> block_shift) * block_size;
@@ -607,6 +737,22 @@ void TextureCache::upload_texture(const SceGxmTexture &gxm_texture, MemState &me
     }
 }
 
+void TextureCache::upload_decoded_texture(const DecodedTexture &decoded) {
+    R_PROFILE(__func__);
+
+    for (const DecodedTextureLevel &level : decoded.levels) {
+        upload_texture_impl(level.format, level.width, level.height, level.mip_index, level.pixels, level.face, level.pixels_per_stride);
+        if (export_textures)
+            export_texture_impl(level.format, level.width, level.height, level.mip_index, level.pixels, level.face, level.pixels_per_stride);
+    }
+}
+
+void TextureCache::upload_texture(const SceGxmTexture &gxm_texture, MemState &mem) {
+    DecodedTexture decoded;
+    decode_texture(gxm_texture, mem, decoded);
+    upload_decoded_texture(decoded);
+}
+
 // remove everything related to the sampler state
 static constexpr TextureGxmDataRepr default_texture_mask = {
     0x981E0000,
@@ -621,6 +767,64 @@ static constexpr TextureGxmDataRepr strided_texture_mask = {
     0xF3FFFFFF
 };
 
+// reading the result back from the disk is only faster than these conversions
+static bool is_conversion_expensive(const SceGxmTextureBaseFormat base_format, const bool is_vulkan, const bool support_dxt) {
+    switch (base_format) {
+    case SCE_GXM_TEXTURE_BASE_FORMAT_PVRT2BPP:
+    case SCE_GXM_TEXTURE_BASE_FORMAT_PVRT4BPP:
+    case SCE_GXM_TEXTURE_BASE_FORMAT_PVRTII2BPP:
+    case SCE_GXM_TEXTURE_BASE_FORMAT_PVRTII4BPP:
+        return true;
+    case SCE_GXM_TEXTURE_BASE_FORMAT_SE5M9M9M9:
+        return !is_vulkan;
+    case SCE_GXM_TEXTURE_BASE_FORMAT_U2F10F10F10:
+        return is_vulkan;
+    default:
+        return gxm::is_bcn_format(base_format) && !support_dxt;
+    }
+}
+
+void TextureCache::decode_texture(const SceGxmTexture &gxm_texture, const MemState &mem, DecodedTexture &decoded) {
+    const SceGxmTextureBaseFormat base_format = gxm::get_base_format(gxm::get_format(gxm_texture));
+    const bool is_vulkan = (backend == renderer::Backend::Vulkan);
+    const Ptr<const uint8_t> data(gxm_texture.data_addr << 2);
+    if (!decoded_cache.is_enabled() || !data || !is_conversion_expensive(base_format, is_vulkan, support_dxt)) {
+        convert_texture(gxm_texture, mem, decoded);
+        return;
+    }
+
+    // everything the conversion depends on, the address and sampler state are left out
+    TextureGxmDataRepr texture_repr = std::bit_cast<TextureGxmDataRepr>(gxm_texture);
+    const TextureGxmDataRepr &mask = (gxm_texture.texture_type() == SCE_GXM_TEXTURE_LINEAR_STRIDED) ? strided_texture_mask : default_texture_mask;
+    for (int i = 0; i < 4; i++)
+        texture_repr[i] &= mask[i];
+    SceGxmTexture texture_layout = std::bit_cast<SceGxmTexture>(texture_repr);
+    texture_layout.data_addr = 0;
+
+    struct {
+        uint64_t content_hash;
+        TextureGxmDataRepr texture;
+        uint32_t is_vulkan;
+        uint32_t support_dxt;
+    } key_data = {
+        hash_data_chunked(data.get(mem), gxm::texture_size_full(gxm_texture), nullptr),
+        std::bit_cast<TextureGxmDataRepr>(texture_layout),
+        is_vulkan,
+        support_dxt
+    };
+    const uint64_t key = hash_data(&key_data, sizeof(key_data));
+
+    if (decoded_cache.load(key, decoded))
+        return;
+
+    convert_texture(gxm_texture, mem, decoded);
+    const bool is_converted = std::all_of(decoded.levels.begin(), decoded.levels.end(), [](const DecodedTextureLevel &level) {
+        return level.size > 0;
+    });
+    if (is_converted)
+        decoded_cache.store(key, decoded);
+}
+
 void TextureCache::cache_and_bind_texture(const SceGxmTexture &gxm_texture, MemState &mem) {
     R_PROFILE(__func__);
 
@@ -657,6 +861,8 @@ void TextureCache::cache_and_bind_texture(const SceGxmTexture &gxm_texture, MemS
             texture_lookup.erase(std::bit_cast<TextureGxmDataRepr>(info->texture));
         }
         texture_lookup[texture_repr] = info;
+        // a decode of the previous texture in this slot is of no use anymore
+        pending_decodes[index] = {};
 
         configure = true;
         upload = true;
@@ -682,11 +888,15 @@ void TextureCache::cache_and_bind_texture(const SceGxmTexture &gxm_texture, MemS
 
         info->use_hash = should_use_hash;
         if (info->use_hash) {
+            if (use_protect && gxm_texture.data_addr)
+                // arm before hashing so that a write happening during the hash is not missed
+                info->write_epoch = track_writes(mem, gxm_texture.data_addr << 2, info->texture_size);
             if (import_textures || export_textures)
                 info->hash = hash_texture_nostride(gxm_texture, mem);
             else
                 // the xor 1 is to make sure it won't be the same as hash_texture_nostride
-                info->hash = hash_texture_data(gxm_texture, info->texture_size, mem) ^ 1;
+                info->hash = hash_texture_data(gxm_texture, info->texture_size, mem, &hash_pool) ^ 1;
+            info->hash_frame = frame_generation;
         }
     } else {
         // Texture is cached.
@@ -694,17 +904,27 @@ void TextureCache::cache_and_bind_texture(const SceGxmTexture &gxm_texture, MemS
         info = gxm_it->second;
         configure = false;
         if (info->use_hash) {
-            const uint64_t previous_hash = info->hash;
-            if (import_textures || export_textures)
-                info->hash = hash_texture_nostride(gxm_texture, mem);
-            else
-                info->hash = hash_texture_data(gxm_texture, info->texture_size, mem) ^ 1;
-
-            upload = previous_hash != info->hash;
+            // a texture bound by multiple draws is only hashed again in the same frame if its pages were written to,
+            // which can only be known if they are tracked
+            const bool track_hash = use_protect && gxm_texture.data_addr;
+            const bool already_hashed = track_hash && info->hash_frame == frame_generation && !info->dirty
+                && !is_range_written(mem, gxm_texture.data_addr << 2, info->texture_size, info->write_epoch);
+            if (!already_hashed) {
+                const uint64_t previous_hash = info->hash;
+                if (track_hash)
+                    info->write_epoch = track_writes(mem, gxm_texture.data_addr << 2, info->texture_size);
+                if (import_textures || export_textures)
+                    info->hash = hash_texture_nostride(gxm_texture, mem);
+                else
+                    info->hash = hash_texture_data(gxm_texture, info->texture_size, mem, &hash_pool) ^ 1;
+                info->hash_frame = frame_generation;
+
+                upload = info->dirty || previous_hash != info->hash;
+            }
         } else {
             range_protect_begin = align(gxm_texture.data_addr << 2, mem.page_size);
             range_protect_end = align_down((gxm_texture.data_addr << 2) + info->texture_size, mem.page_size);
-            upload = info->dirty;
+            upload = info->dirty || is_range_written(mem, range_protect_begin, range_protect_end - range_protect_begin, info->write_epoch);
         }
     }
     current_info = info;
@@ -736,6 +956,12 @@ void TextureCache::cache_and_bind_texture(const SceGxmTexture &gxm_texture, MemS
     if (upload && !importing_texture && info->is_imported)
         configure = true;
 
+    PendingTextureDecode &pending = pending_decodes[index];
+    const bool decode_async = upload && !importing_texture && can_decode_async(gxm_texture);
+    if (upload && !decode_async)
+        // what is being decoded is older than what is going to be uploaded
+        pending = {};
+
     select(index, gxm_texture);
 
     if (configure) {
@@ -751,33 +977,50 @@ void TextureCache::cache_and_bind_texture(const SceGxmTexture &gxm_texture, MemS
         }
     }
     if (upload) {
-        if (export_textures && !importing_texture)
-            export_select(gxm_texture);
+        info->dirty = false;
+        // arm the tracking before reading the texture so that a concurrent write is not missed
+        if (!info->use_hash) {
+            info->write_epoch = track_writes(mem, range_protect_begin, range_protect_end - range_protect_begin);
+        }
 
-        if (importing_texture)
-            import_upload_texture();
-        else
-            upload_texture(gxm_texture, mem);
+        if (decode_async) {
+            if (pending.result.valid()) {
+                // only one decode per texture at a time, another one is requested once this one is uploaded
+                pending.stale = true;
+            } else {
+                pending.result = decode_pool.submit([this, gxm_texture, &mem] {
+                    DecodedTexture decoded;
+                    decode_texture(gxm_texture, mem, decoded);
+                    return decoded;
+                });
+            }
 
-        if (!info->use_hash) {
-            info->dirty = false;
-            add_protect(mem, range_protect_begin, range_protect_end - range_protect_begin, MemPerm::ReadOnly, [info, texture_repr](Address, bool) {
-                if (memcmp(&info->texture, &texture_repr, sizeof(SceGxmTexture)) == 0) {
-                    info->dirty = true;
-                }
+            if (configure) {
+                // nothing to show until the decode is done
+                clear_texture();
+                upload_done();
+            }
+        } else {
+            if (export_textures && !importing_texture)
+                export_select(gxm_texture);
 
-                return true;
-            });
-        }
+            if (importing_texture)
+                import_upload_texture();
+            else
+                upload_texture(gxm_texture, mem);
 
-        upload_done();
-        if (export_textures && !importing_texture)
-            export_done();
-        if (importing_texture)
-            import_done();
+            upload_done();
+            if (export_textures && !importing_texture)
+                export_done();
+            if (importing_texture)
+                import_done();
+        }
     }
     importing_texture = false;
 
+    if (pending.result.valid())
+        upload_pending_decode(*info);
+
     // set the texture as the mru
     texture_queue.set_as_mru(info);
 
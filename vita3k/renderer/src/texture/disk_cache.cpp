@@ -0,0 +1,348 @@
+// Vita3K emulator project
+// Copyright (C) 2024 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <renderer/functions.h>
+#include <renderer/texture_cache.h>
+#include <renderer/texture_disk_cache.h>
+
+#include <gxm/functions.h>
+#include <util/align.h>
+#include <util/log.h>
+
+#include <algorithm>
+#include <cassert>
+#include <ctime>
+#include <vector>
+
+#ifdef WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace renderer {
+
+MappedFile::~MappedFile() {
+    if (!content)
+        return;
+
+#ifdef WIN32
+    UnmapViewOfFile(content);
+#else
+    munmap(const_cast<uint8_t *>(content), content_size);
+#endif
+}
+
+bool MappedFile::open(const fs::path &path) {
+#ifdef WIN32
+    HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping)
+        return false;
+
+    // the view keeps the mapping alive
+    content = static_cast<const uint8_t *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    CloseHandle(mapping);
+    if (!content)
+        return false;
+
+    content_size = static_cast<size_t>(file_size.QuadPart);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+        close(fd);
+        return false;
+    }
+
+    void *mapping = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+        return false;
+
+    content = static_cast<const uint8_t *>(mapping);
+    content_size = file_stat.st_size;
+#endif
+
+    return true;
+}
+
+static constexpr uint32_t decoded_texture_magic = 0x54444356; // VCDT
+// increase it when the content of a decoded texture changes
+static constexpr uint32_t decoded_texture_version = 1;
+
+struct DecodedTextureFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t nb_levels;
+    uint32_t padding;
+};
+
+struct DecodedTextureFileLevel {
+    uint32_t format;
+    uint32_t width;
+    uint32_t height;
+    uint32_t mip_index;
+    int32_t face;
+    uint32_t pixels_per_stride;
+    // from the beginning of the file
+    uint64_t offset;
+    uint64_t size;
+};
+
+DecodedTextureDiskCache::~DecodedTextureDiskCache() {
+    if (hits > 0 || misses > 0)
+        LOG_INFO("Decoded texture cache: {} hits, {} misses, {} stores, {} evictions, {} MiB on disk", hits.load(), misses.load(), stores.load(), evictions.load(), total_size / (1024 * 1024));
+}
+
+fs::path DecodedTextureDiskCache::get_path(uint64_t key) const {
+    return folder / fmt::format("{:016X}.bin", key);
+}
+
+void DecodedTextureDiskCache::init(const fs::path &folder, uint64_t max_size) {
+    this->folder = folder;
+    this->max_size = max_size;
+
+    boost::system::error_code error;
+    fs::create_directories(folder, error);
+    if (error) {
+        LOG_ERROR("Could not create the decoded texture cache folder {}: {}", folder, error.message());
+        this->folder.clear();
+        return;
+    }
+
+    struct FoundFile {
+        uint64_t key;
+        uint64_t size;
+        std::time_t last_use;
+    };
+    std::vector<FoundFile> found_files;
+    // the files can be removed or unreadable while iterating, skip them instead of throwing
+    for (fs::directory_iterator it(folder, error), end; !error && it != end; it.increment(error)) {
+        const fs::path &file = it->path();
+        boost::system::error_code file_error;
+        if (!fs::is_regular_file(file, file_error))
+            continue;
+
+        if (file.extension() != ".bin") {
+            // a temporary file left by a crash during a store
+            fs::remove(file, file_error);
+            continue;
+        }
+
+        uint64_t key;
+        try {
+            key = std::stoull(file.stem().string(), nullptr, 16);
+        } catch (...) {
+            continue;
+        }
+
+        // the last write time is updated each time a file is loaded
+        const uint64_t size = fs::file_size(file, file_error);
+        if (file_error)
+            continue;
+        const std::time_t last_use = fs::last_write_time(file, file_error);
+        if (file_error)
+            continue;
+
+        found_files.push_back({ key, size, last_use });
+    }
+    if (error)
+        LOG_WARN("Could not list the decoded texture cache folder {}: {}", folder, error.message());
+
+    std::sort(found_files.begin(), found_files.end(), [](const FoundFile &a, const FoundFile &b) {
+        return a.last_use > b.last_use;
+    });
+
+    const std::lock_guard<std::mutex> lock(mutex);
+    for (const FoundFile &file : found_files) {
+        lru.push_back({ file.key, file.size });
+        entries[file.key] = std::prev(lru.end());
+        total_size += file.size;
+    }
+    evict();
+}
+
+// number of bytes the backends read when uploading the level
+static uint64_t get_level_upload_size(const DecodedTextureFileLevel &level) {
+    const SceGxmTextureBaseFormat format = static_cast<SceGxmTextureBaseFormat>(level.format);
+    const uint32_t pixels_per_stride = level.pixels_per_stride ? level.pixels_per_stride : level.width;
+    if (gxm::is_bcn_format(format) || texture::is_astc_format(format))
+        return texture::get_compressed_size(format, pixels_per_stride, level.height);
+
+    const uint64_t bytes_per_pixel = (gxm::bits_per_pixel(format) + 7) >> 3;
+    return static_cast<uint64_t>(pixels_per_stride) * level.height * bytes_per_pixel;
+}
+
+bool DecodedTextureDiskCache::load(uint64_t key, DecodedTexture &decoded) {
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(key);
+        if (it == entries.end()) {
+            misses++;
+            return false;
+        }
+        lru.splice(lru.begin(), lru, it->second);
+    }
+
+    const fs::path path = get_path(key);
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(path)) {
+        misses++;
+        return false;
+    }
+
+    const uint8_t *content = file->data();
+    const DecodedTextureFileHeader *header = reinterpret_cast<const DecodedTextureFileHeader *>(content);
+    if (file->size() < sizeof(DecodedTextureFileHeader) || header->magic != decoded_texture_magic || header->version != decoded_texture_version
+        || file->size() < sizeof(DecodedTextureFileHeader) + static_cast<size_t>(header->nb_levels) * sizeof(DecodedTextureFileLevel)) {
+        // outdated or corrupted, it will be replaced by the next store
+        misses++;
+        return false;
+    }
+
+    const DecodedTextureFileLevel *levels = reinterpret_cast<const DecodedTextureFileLevel *>(content + sizeof(DecodedTextureFileHeader));
+    decoded.levels.clear();
+    for (uint32_t i = 0; i < header->nb_levels; i++) {
+        const DecodedTextureFileLevel &level = levels[i];
+        // a level smaller than what its dimensions say would make the upload read past the mapping
+        if (level.offset > file->size() || level.size > file->size() - level.offset
+            || (level.pixels_per_stride && level.width > level.pixels_per_stride) || get_level_upload_size(level) > level.size) {
+            decoded.levels.clear();
+            misses++;
+            return false;
+        }
+
+        decoded.levels.push_back({ static_cast<SceGxmTextureBaseFormat>(level.format), level.width, level.height, level.mip_index,
+            level.face, level.pixels_per_stride, content + level.offset, static_cast<size_t>(level.size) });
+    }
+    decoded.file = std::move(file);
+
+    // keep the usage order for the next boots
+    boost::system::error_code error;
+    fs::last_write_time(path, std::time(nullptr), error);
+
+    hits++;
+    return true;
+}
+
+void DecodedTextureDiskCache::store(uint64_t key, const DecodedTexture &decoded) {
+    if (decoded.levels.empty())
+        return;
+
+    DecodedTextureFileHeader header{
+        .magic = decoded_texture_magic,
+        .version = decoded_texture_version,
+        .nb_levels = static_cast<uint32_t>(decoded.levels.size()),
+        .padding = 0
+    };
+
+    // the level data is 16-bytes aligned, some formats need it for the upload
+    std::vector<DecodedTextureFileLevel> levels;
+    uint64_t offset = align(sizeof(DecodedTextureFileHeader) + decoded.levels.size() * sizeof(DecodedTextureFileLevel), 16);
+    for (const DecodedTextureLevel &level : decoded.levels) {
+        assert(level.size > 0);
+        levels.push_back({ static_cast<uint32_t>(level.format), level.width, level.height, level.mip_index,
+            level.face, level.pixels_per_stride, offset, level.size });
+        offset = align(offset + level.size, 16);
+    }
+    const uint64_t file_size = offset;
+
+    // write everything to a temporary file first so that a partially written file is never loaded
+    const fs::path path = get_path(key);
+    const fs::path temp_path = folder / fmt::format("{:016X}.tmp{}", key, temp_file_idx++);
+    {
+        fs::ofstream file(temp_path, std::ios::out | std::ios::binary);
+        if (!file.is_open())
+            return;
+
+        constexpr char padding[16] = {};
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(levels.data()), levels.size() * sizeof(DecodedTextureFileLevel));
+        for (size_t i = 0; i < levels.size(); i++) {
+            file.write(padding, static_cast<std::streamsize>(levels[i].offset) - file.tellp());
+            file.write(reinterpret_cast<const char *>(decoded.levels[i].pixels), decoded.levels[i].size);
+        }
+        file.write(padding, static_cast<std::streamsize>(file_size) - file.tellp());
+
+        if (!file) {
+            file.close();
+            boost::system::error_code error;
+            fs::remove(temp_path, error);
+            return;
+        }
+    }
+
+    const std::lock_guard<std::mutex> lock(mutex);
+    boost::system::error_code error;
+    fs::rename(temp_path, path, error);
+    if (error) {
+        fs::remove(temp_path, error);
+        return;
+    }
+
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+        // the file has been replaced
+        total_size -= it->second->size;
+        lru.erase(it->second);
+    }
+    lru.push_front({ key, file_size });
+    entries[key] = lru.begin();
+    total_size += file_size;
+    stores++;
+
+    evict();
+}
+
+void DecodedTextureDiskCache::evict() {
+    boost::system::error_code error;
+    while (total_size > max_size && !lru.empty()) {
+        const Entry &entry = lru.back();
+        // a mapped file can't be removed on Windows, it stays on the disk until the next boot
+        fs::remove(get_path(entry.key), error);
+
+        total_size -= entry.size;
+        entries.erase(entry.key);
+        lru.pop_back();
+        evictions++;
+    }
+}
+
+DecodedTextureDiskCacheStats DecodedTextureDiskCache::stats() const {
+    const std::lock_guard<std::mutex> lock(mutex);
+    return { hits.load(), misses.load(), stores.load(), evictions.load(), total_size };
+}
+
+} // namespace renderer
@@ -343,54 +343,6 @@ uint32_t encode_morton(uint16_t x, uint16_t y, uint16_t width, uint16_t height)
     return result;
 }
 
-void swizzled_texture_to_linear_texture(uint8_t *dest, const uint8_t *src, uint16_t width, uint16_t height, uint8_t bits_per_pixel) {
-    if (bits_per_pixel % 8 != 0) {
-        // Don't support yet
-        return;
-    }
-
-    uint8_t bytes_per_pixel = (bits_per_pixel + 7) >> 3;
-    uint32_t min = std::min(width, height);
-    uint32_t k = std::bit_width(min) - 1;
-
-    for (uint32_t i = 0; i < width * static_cast<uint32_t>(height); i++) {
-        uint32_t x = decode_morton2_x(i) & (min - 1);
-        uint32_t y = decode_morton2_y(i) & (min - 1);
-        uint32_t upper_bits = (i >> (2 * k)) << k;
-        if (width >= height) {
-            x |= upper_bits;
-        } else {
-            y |= upper_bits;
-        }
-
-        memcpy(dest + (y * width + x) * bytes_per_pixel, src + i * bytes_per_pixel, bytes_per_pixel);
-    }
-}
-
-void tiled_texture_to_linear_texture(uint8_t *dest, const uint8_t *src, uint16_t width, uint16_t height, uint8_t bits_per_pixel) {
-    // 32x32 block is assembled to tiled.
-    if (bits_per_pixel % 8 != 0) {
-        // Don't support yet
-        return;
-    }
-
-    const uint32_t bpp = bits_per_pixel >> 3;
-    const uint32_t width_in_tiles = (width + 31) >> 5;
-
-    for (uint16_t y = 0; y < height; y++) {
-        for (uint16_t x = 0; x < width; x++) {
-            // Calculate texel address in tile
-            const uint32_t texel_offset_in_tile = (x & 0b11111) | ((y & 0b11111) << 5);
-            const uint32_t tile_address = (x >> 5) + width_in_tiles * (y >> 5);
-
-            const uint32_t offset = ((tile_address << 10) | (texel_offset_in_tile)) * bpp;
-
-            // Make scanline
-            memcpy(dest + ((y * width) + x) * bpp, src + offset, bpp);
-        }
-    }
-}
-
 uint32_t get_compressed_size(SceGxmTextureBaseFormat base_format, uint32_t width, uint32_t height) {
     switch (base_format) {
     case SCE_GXM_TEXTURE_BASE_FORMAT_UBC1:
@@ -0,0 +1,450 @@
+// Vita3K emulator project
+// Copyright (C) 2024 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+/*
+conversion between linear textures and swizzled (morton order) or tiled (32x32 tiles) ones
+swizzled textures are converted by 4x4 blocks: the 16 texels of a block are contiguous in the swizzled
+texture and the offset of each block is the sum of a column and a row offset computed once per conversion
+1 program compiled for aarch64: always use NEON to shuffle the blocks
+2 x86: SSE2 for 32 and 64-bit texels, SSSE3 for 8 and 16-bit texels if the runtime cpu supports it
+other texel sizes and non power of two textures use a scalar path
+*/
+
+#include <renderer/functions.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <vector>
+
+namespace renderer::texture {
+
+// index in the swizzled 4x4 block of each texel of the linear block (row * 4 + column)
+static constexpr std::array<uint8_t, 16> BLOCK_LINEAR_TO_SWIZZLED = { 0, 2, 8, 10, 1, 3, 9, 11, 4, 6, 12, 14, 5, 7, 13, 15 };
+
+// index in the linear 4x4 block of each texel of the swizzled block
+static constexpr std::array<uint8_t, 16> BLOCK_SWIZZLED_TO_LINEAR = [] {
+    std::array<uint8_t, 16> inverse{};
+    for (uint8_t i = 0; i < 16; i++)
+        inverse[BLOCK_LINEAR_TO_SWIZZLED[i]] = i;
+    return inverse;
+}();
+
+// byte shuffle table gathering the texels of size bytes_per_texel in the given order
+template <size_t bytes_per_texel, size_t count>
+static constexpr std::array<uint8_t, count * bytes_per_texel> make_byte_shuffle(const std::array<uint8_t, count> &texels) {
+    std::array<uint8_t, count * bytes_per_texel> shuffle{};
+    for (size_t i = 0; i < count; i++)
+        for (size_t b = 0; b < bytes_per_texel; b++)
+            shuffle[i * bytes_per_texel + b] = static_cast<uint8_t>(texels[i] * bytes_per_texel + b);
+    return shuffle;
+}
+
+// copy one swizzled block (16 contiguous texels) to 4 rows of 4 texels
+typedef void (*UnswizzleBlockFunc)(uint8_t *dst, size_t dst_pitch, const uint8_t *src);
+// copy 4 rows of 4 texels to one swizzled block
+typedef void (*SwizzleBlockFunc)(uint8_t *dst, const uint8_t *src, size_t src_pitch);
+
+template <size_t bytes_per_texel>
+static void unswizzle_block_basic(uint8_t *dst, size_t dst_pitch, const uint8_t *src) {
+    for (size_t i = 0; i < 16; i++)
+        memcpy(dst + (i / 4) * dst_pitch + (i % 4) * bytes_per_texel, src + BLOCK_LINEAR_TO_SWIZZLED[i] * bytes_per_texel, bytes_per_texel);
+}
+
+template <size_t bytes_per_texel>
+static void swizzle_block_basic(uint8_t *dst, const uint8_t *src, size_t src_pitch) {
+    for (size_t i = 0; i < 16; i++)
+        memcpy(dst + BLOCK_LINEAR_TO_SWIZZLED[i] * bytes_per_texel, src + (i / 4) * src_pitch + (i % 4) * bytes_per_texel, bytes_per_texel);
+}
+
+struct BlockFuncs {
+    UnswizzleBlockFunc unswizzle;
+    SwizzleBlockFunc swizzle;
+};
+
+static BlockFuncs get_basic_block_funcs(const uint32_t bytes_per_texel) {
+    switch (bytes_per_texel) {
+    case 1: return { unswizzle_block_basic<1>, swizzle_block_basic<1> };
+    case 2: return { unswizzle_block_basic<2>, swizzle_block_basic<2> };
+    case 3: return { unswizzle_block_basic<3>, swizzle_block_basic<3> };
+    case 4: return { unswizzle_block_basic<4>, swizzle_block_basic<4> };
+    case 8: return { unswizzle_block_basic<8>, swizzle_block_basic<8> };
+    case 16: return { unswizzle_block_basic<16>, swizzle_block_basic<16> };
+    default: return { nullptr, nullptr };
+    }
+}
+
+} // namespace renderer::texture
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+
+namespace renderer::texture {
+static void unswizzle_block_8(uint8_t *dst, size_t dst_pitch, const uint8_t *src) {
+    static constexpr auto shuffle = BLOCK_LINEAR_TO_SWIZZLED;
+    alignas(16) uint8_t rows[16];
+    vst1q_u8(rows, vqtbl1q_u8(vld1q_u8(src), vld1q_u8(shuffle.data())));
+    for (size_t row = 0; row < 4; row++)
+        memcpy(dst + row * dst_pitch, rows + row * 4, 4);
+}
+
+static void swizzle_block_8(uint8_t *dst, const uint8_t *src, size_t src_pitch) {
+    static constexpr auto shuffle = BLOCK_SWIZZLED_TO_LINEAR;
+    alignas(16) uint8_t rows[16];
+    for (size_t row = 0; row < 4; row++)
+        memcpy(rows + row * 4, src + row * src_pitch, 4);
+    vst1q_u8(dst, vqtbl1q_u8(vld1q_u8(rows), vld1q_u8(shuffle.data())));
+}
+
+static void unswizzle_block_16(uint8_t *dst, size_t dst_pitch, const uint8_t *src) {
+    static constexpr auto shuffle = make_byte_shuffle<2>(BLOCK_LINEAR_TO_SWIZZLED);
+    const uint8x16x2_t block = { vld1q_u8(src), vld1q_u8(src + 16) };
+    const uint8x16_t rows01 = vqtbl2q_u8(block, vld1q_u8(shuffle.data()));
+    const uint8x16_t rows23 = vqtbl2q_u8(block, vld1q_u8(shuffle.data() + 16));
+    vst1_u8(dst, vget_low_u8(rows01));
+    vst1_u8(dst + dst_pitch, vget_high_u8(rows01));
+    vst1_u8(dst + 2 * dst_pitch, vget_low_u8(rows23));
+    vst1_u8(dst + 3 * dst_pitch, vget_high_u8(rows23));
+}
+
+static void swizzle_block_16(uint8_t *dst, const uint8_t *src, size_t src_pitch) {
+    static constexpr auto shuffle = make_byte_shuffle<2>(BLOCK_SWIZZLED_TO_LINEAR);
+    const uint8x16x2_t rows = {
+        vcombine_u8(vld1_u8(src), vld1_u8(src + src_pitch)),
+        vcombine_u8(vld1_u8(src + 2 * src_pitch), vld1_u8(src + 3 * src_pitch))
+    };
+    vst1q_u8(dst, vqtbl2q_u8(rows, vld1q_u8(shuffle.data())));
+    vst1q_u8(dst + 16, vqtbl2q_u8(rows, vld1q_u8(shuffle.data() + 16)));
+}
+
+static void unswizzle_block_32(uint8_t *dst, size_t dst_pitch, const uint8_t *src) {
+    // the swizzled block is 4 vectors of texels: 0-3, 4-7, 8-11, 12-15
+    // and the rows are: 0 2 8 10 / 1 3 9 11 / 4 6 12 14 / 5 7 13 15
+    const uint32x4_t s0 = vreinterpretq_u32_u8(vld1q_u8(src));
+    const uint32x4_t s1 = vreinterpretq_u32_u8(vld1q_u8(src + 16));
+    const uint32x4_t s2 = vreinterpretq_u32_u8(vld1q_u8(src + 32));
+    const uint32x4_t s3 = vreinterpretq_u32_u8(vld1q_u8(src + 48));
+    vst1q_u8(dst, vreinterpretq_u8_u32(vuzp1q_u32(s0, s2)));
+    vst1q_u8(dst + dst_pitch, vreinterpretq_u8_u32(vuzp2q_u32(s0, s2)));
+    vst1q_u8(dst + 2 * dst_pitch, vreinterpretq_u8_u32(vuzp1q_u32(s1, s3)));
+    vst1q_u8(dst + 3 * dst_pitch, vreinterpretq_u8_u32(vuzp2q_u32(s1, s3)));
+}
+
+static void swizzle_block_32(uint8_t *dst, const uint8_t *src, size_t src_pitch) {
+    const uint32x4_t r0 = vreinterpretq_u32_u8(vld1q_u8(src));
+    const uint32x4_t r1 = vreinterpretq_u32_u8(vld1q_u8(src + src_pitch));
+    const uint32x4_t r2 = vreinterpretq_u32_u8(vld1q_u8(src + 2 * src_pitch));
+    const uint32x4_t r3 = vreinterpretq_u32_u8(vld1q_u8(src + 3 * src_pitch));
+    vst1q_u8(dst, vreinterpretq_u8_u32(vzip1q_u32(r0, r1)));
+    vst1q_u8(dst + 16, vreinterpretq_u8_u32(vzip1q_u32(r2, r3)));
+    vst1q_u8(dst + 32, vreinterpretq_u8_u32(vzip2q_u32(r0, r1)));
+    vst1q_u8(dst + 48, vreinterpretq_u8_u32(vzip2q_u32(r2, r3)));
+}
+
+static void unswizzle_block_64(uint8_t *dst, size_t dst_pitch, const uint8_t *src) {
+    uint64x2_t s[8];
+    for (size_t i = 0; i < 8; i++)
+        s[i] = vreinterpretq_u64_u8(vld1q_u8(src + i * 16));
+    for (size_t row = 0; row < 4; row++) {
+        // rows 0 and 1 come from texels 0-3 and 8-11, rows 2 and 3 from texels 4-7 and 12-15
+        const size_t first = (row / 2) * 2;
+        uint8_t *const row_dst = dst + row * dst_pitch;
+        if (row % 2 == 0) {
+            vst1q_u8(row_dst, vreinterpretq_u8_u64(vzip1q_u64(s[first], s[first + 1])));
+            vst1q_u8(row_dst + 16, vreinterpretq_u8_u64(vzip1q_u64(s[first + 4], s[first + 5])));
+        } else {
+            vst1q_u8(row_dst, vreinterpretq_u8_u64(vzip2q_u64(s[first], s[first + 1])));
+            vst1q_u8(row_dst + 16, vreinterpretq_u8_u64(vzip2q_u64(s[first + 4], s[first + 5])));
+        }
+    }
+}
+
+static void swizzle_block_64(uint8_t *dst, const uint8_t *src, size_t src_pitch) {
+    for (size_t half = 0; half < 2; half++) {
+        // each half of the rows is 2 texels wide
+        for (size_t rows = 0; rows < 4; rows += 2) {
+            const uint64x2_t even = vreinterpretq_u64_u8(vld1q_u8(src + rows * src_pitch + half * 16));
+            const uint64x2_t odd = vreinterpretq_u64_u8(vld1q_u8(src + (rows + 1) * src_pitch + half * 16));
+            uint8_t *const block_dst = dst + (half * 4 + rows) * 16;
+            vst1q_u8(block_dst, vreinterpretq_u8_u64(vzip1q_u64(even, odd)));
+            vst1q_u8(block_dst + 16, vreinterpretq_u8_u64(vzip2q_u64(even, odd)));
+        }
+    }
+}
+
+static BlockFuncs get_block_funcs(const uint32_t bytes_per_texel) {
+    switch (bytes_per_texel) {
+    case 1: return { unswizzle_block_8, swizzle_block_8 };
+    case 2: return { unswizzle_block_16, swizzle_block_16 };
+    case 4: return { unswizzle_block_32, swizzle_block_32 };
+    case 8: return { unswizzle_block_64, swizzle_block_64 };
+    default: return get_basic_block_funcs(bytes_per_texel);
+    }
+}
+} // namespace renderer::texture
+#else
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_SSSE3 __attribute__((__target__("ssse3")))
+#include <immintrin.h>
+#elif defined(_MSC_VER)
+#define TARGET_SSSE3
+#include <intrin.h>
+#else
+#error "Compiler is not supported"
+#endif
+
+#include <util/instrset_detect.h>
+
+namespace renderer::texture {
+static void TARGET_SSSE3 unswizzle_block_8(uint8_t *dst, size_t dst_pitch, const uint8_t *src) {
+    static constexpr auto shuffle = BLOCK_LINEAR_TO_SWIZZLED;
+    alignas(16) uint8_t rows[16];
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+    _mm_store_si128(reinterpret_cast<__m128i *>(rows), _mm_shuffle_epi8(block, _mm_loadu_si128(reinterpret_cast<const __m128i *>(shuffle.data()))));
+    for (size_t row = 0; row < 4; row++)
+        memcpy(dst + row * dst_pitch, rows + row * 4, 4);
+}
+
+static void TARGET_SSSE3 swizzle_block_8(uint8_t *dst, const uint8_t *src, size_t src_pitch) {
+    static constexpr auto shuffle = BLOCK_SWIZZLED_TO_LINEAR;
+    alignas(16) uint8_t rows[16];
+    for (size_t row = 0; row < 4; row++)
+        memcpy(rows + row * 4, src + row * src_pitch, 4);
+    const __m128i block = _mm_load_si128(reinterpret_cast<const __m128i *>(rows));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_shuffle_epi8(block, _mm_loadu_si128(reinterpret_cast<const __m128i *>(shuffle.data()))));
+}
+
+// swaps texels 1 and 2 of each group of 4 16-bit texels, its own inverse
+static constexpr std::array<uint8_t, 16> SWAP_MIDDLE_TEXELS_16 = make_byte_shuffle<2>(std::array<uint8_t, 8>{ 0, 2, 1, 3, 4, 6, 5, 7 });
+
+static void TARGET_SSSE3 unswizzle_block_16(uint8_t *dst, size_t dst_pitch, const uint8_t *src) {
+    const __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i *>(SWAP_MIDDLE_TEXELS_16.data()));
+    // texels 0 2 1 3 4 6 5 7 and 8 10 9 11 12 14 13 15
+    const __m128i s0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src)), shuffle);
+    const __m128i s1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 16)), shuffle);
+    const __m128i rows01 = _mm_unpacklo_epi32(s0, s1);
+    const __m128i rows23 = _mm_unpackhi_epi32(s0, s1);
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(dst), rows01);
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + dst_pitch), _mm_unpackhi_epi64(rows01, rows01));
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + 2 * dst_pitch), rows23);
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + 3 * dst_pitch), _mm_unpackhi_epi64(rows23, rows23));
+}
+
+static void TARGET_SSSE3 swizzle_block_16(uint8_t *dst, const uint8_t *src, size_t src_pitch) {
+    const __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i *>(SWAP_MIDDLE_TEXELS_16.data()));
+    const __m128 rows01 = _mm_castsi128_ps(_mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(src)),
+        _mm_loadl_epi64(reinterpret_cast<const __m128i *>(src + src_pitch))));
+    const __m128 rows23 = _mm_castsi128_ps(_mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(src + 2 * src_pitch)),
+        _mm_loadl_epi64(reinterpret_cast<const __m128i *>(src + 3 * src_pitch))));
+    const __m128i s0 = _mm_castps_si128(_mm_shuffle_ps(rows01, rows23, _MM_SHUFFLE(2, 0, 2, 0)));
+    const __m128i s1 = _mm_castps_si128(_mm_shuffle_ps(rows01, rows23, _MM_SHUFFLE(3, 1, 3, 1)));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_shuffle_epi8(s0, shuffle));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 16), _mm_shuffle_epi8(s1, shuffle));
+}
+
+static void unswizzle_block_32(uint8_t *dst, size_t dst_pitch, const uint8_t *src) {
+    // the swizzled block is 4 vectors of texels: 0-3, 4-7, 8-11, 12-15
+    // and the rows are: 0 2 8 10 / 1 3 9 11 / 4 6 12 14 / 5 7 13 15
+    const __m128 s0 = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src)));
+    const __m128 s1 = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 16)));
+    const __m128 s2 = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 32)));
+    const __m128 s3 = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 48)));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_castps_si128(_mm_shuffle_ps(s0, s2, _MM_SHUFFLE(2, 0, 2, 0))));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + dst_pitch), _mm_castps_si128(_mm_shuffle_ps(s0, s2, _MM_SHUFFLE(3, 1, 3, 1))));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 2 * dst_pitch), _mm_castps_si128(_mm_shuffle_ps(s1, s3, _MM_SHUFFLE(2, 0, 2, 0))));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 3 * dst_pitch), _mm_castps_si128(_mm_shuffle_ps(s1, s3, _MM_SHUFFLE(3, 1, 3, 1))));
+}
+
+static void swizzle_block_32(uint8_t *dst, const uint8_t *src, size_t src_pitch) {
+    const __m128i r0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+    const __m128i r1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + src_pitch));
+    const __m128i r2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 2 * src_pitch));
+    const __m128i r3 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 3 * src_pitch));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_unpacklo_epi32(r0, r1));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 16), _mm_unpacklo_epi32(r2, r3));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 32), _mm_unpackhi_epi32(r0, r1));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 48), _mm_unpackhi_epi32(r2, r3));
+}
+
+static void unswizzle_block_64(uint8_t *dst, size_t dst_pitch, const uint8_t *src) {
+    __m128i s[8];
+    for (size_t i = 0; i < 8; i++)
+        s[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 16));
+    for (size_t row = 0; row < 4; row++) {
+        // rows 0 and 1 come from texels 0-3 and 8-11, rows 2 and 3 from texels 4-7 and 12-15
+        const size_t first = (row / 2) * 2;
+        __m128i *const row_dst = reinterpret_cast<__m128i *>(dst + row * dst_pitch);
+        if (row % 2 == 0) {
+            _mm_storeu_si128(row_dst, _mm_unpacklo_epi64(s[first], s[first + 1]));
+            _mm_storeu_si128(row_dst + 1, _mm_unpacklo_epi64(s[first + 4], s[first + 5]));
+        } else {
+            _mm_storeu_si128(row_dst, _mm_unpackhi_epi64(s[first], s[first + 1]));
+            _mm_storeu_si128(row_dst + 1, _mm_unpackhi_epi64(s[first + 4], s[first + 5]));
+        }
+    }
+}
+
+static void swizzle_block_64(uint8_t *dst, const uint8_t *src, size_t src_pitch) {
+    for (size_t half = 0; half < 2; half++) {
+        // each half of the rows is 2 texels wide
+        for (size_t rows = 0; rows < 4; rows += 2) {
+            const __m128i even = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + rows * src_pitch + half * 16));
+            const __m128i odd = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + (rows + 1) * src_pitch + half * 16));
+            __m128i *const block_dst = reinterpret_cast<__m128i *>(dst + (half * 4 + rows) * 16);
+            _mm_storeu_si128(block_dst, _mm_unpacklo_epi64(even, odd));
+            _mm_storeu_si128(block_dst + 1, _mm_unpackhi_epi64(even, odd));
+        }
+    }
+}
+
+static BlockFuncs get_block_funcs(const uint32_t bytes_per_texel) {
+    static const bool has_ssse3 = util::instrset::instrset_detect() >= util::instrset::instrset_SSSE3;
+    switch (bytes_per_texel) {
+    case 1: return has_ssse3 ? BlockFuncs{ unswizzle_block_8, swizzle_block_8 } : get_basic_block_funcs(1);
+    case 2: return has_ssse3 ? BlockFuncs{ unswizzle_block_16, swizzle_block_16 } : get_basic_block_funcs(2);
+    case 4: return { unswizzle_block_32, swizzle_block_32 };
+    case 8: return { unswizzle_block_64, swizzle_block_64 };
+    default: return get_basic_block_funcs(bytes_per_texel);
+    }
+}
+} // namespace renderer::texture
+#endif
+
+namespace renderer::texture {
+
+static void swizzled_texture_to_linear_texture_basic(uint8_t *dest, const uint8_t *src, uint16_t width, uint16_t height, uint8_t bytes_per_pixel) {
+    uint32_t min = std::min(width, height);
+    uint32_t k = std::bit_width(min) - 1;
+
+    for (uint32_t i = 0; i < width * static_cast<uint32_t>(height); i++) {
+        uint32_t x = decode_morton2_x(i) & (min - 1);
+        uint32_t y = decode_morton2_y(i) & (min - 1);
+        uint32_t upper_bits = (i >> (2 * k)) << k;
+        if (width >= height) {
+            x |= upper_bits;
+        } else {
+            y |= upper_bits;
+        }
+
+        memcpy(dest + (y * width + x) * bytes_per_pixel, src + i * bytes_per_pixel, bytes_per_pixel);
+    }
+}
+
+// Calls f(linear offset, swizzled offset) in bytes for each 4x4 block of the texture
+// Only valid for power of two textures at least 4 texels wide and high
+template <typename F>
+static void for_each_swizzled_block(const uint16_t width, const uint16_t height, const uint32_t bytes_per_pixel, F f) {
+    // the morton code of (x, y) is the bitwise or of the codes of (x, 0) and (0, y)
+    std::vector<uint32_t> column_offsets(width / 4);
+    for (uint16_t x = 0; x < width; x += 4)
+        column_offsets[x / 4] = encode_morton(x, 0, width, height);
+    std::vector<uint32_t> row_offsets(height / 4);
+    for (uint16_t y = 0; y < height; y += 4)
+        row_offsets[y / 4] = encode_morton(0, y, width, height);
+
+    const size_t pitch = static_cast<size_t>(width) * bytes_per_pixel;
+    for (uint16_t block_y = 0; block_y < height / 4; block_y++) {
+        const size_t linear_row = block_y * 4 * pitch;
+        for (uint16_t block_x = 0; block_x < width / 4; block_x++)
+            f(linear_row + block_x * 4 * bytes_per_pixel, pitch, (column_offsets[block_x] | row_offsets[block_y]) * bytes_per_pixel);
+    }
+}
+
+static bool can_use_swizzled_blocks(const uint16_t width, const uint16_t height) {
+    return std::has_single_bit(width) && std::has_single_bit(height) && width >= 4 && height >= 4;
+}
+
+void swizzled_texture_to_linear_texture(uint8_t *dest, const uint8_t *src, uint16_t width, uint16_t height, uint8_t bits_per_pixel) {
+    if (bits_per_pixel % 8 != 0) {
+        // Don't support yet
+        return;
+    }
+
+    const uint32_t bytes_per_pixel = bits_per_pixel >> 3;
+    const UnswizzleBlockFunc unswizzle_block = get_block_funcs(bytes_per_pixel).unswizzle;
+    if (!unswizzle_block || !can_use_swizzled_blocks(width, height)) {
+        swizzled_texture_to_linear_texture_basic(dest, src, width, height, bytes_per_pixel);
+        return;
+    }
+
+    for_each_swizzled_block(width, height, bytes_per_pixel, [&](size_t linear_offset, size_t pitch, uint32_t swizzled_offset) {
+        unswizzle_block(dest + linear_offset, pitch, src + swizzled_offset);
+    });
+}
+
+void linear_texture_to_swizzled_texture(uint8_t *dest, const uint8_t *src, uint16_t width, uint16_t height, uint8_t bits_per_pixel) {
+    if (bits_per_pixel % 8 != 0) {
+        // Don't support yet
+        return;
+    }
+
+    const uint32_t bytes_per_pixel = bits_per_pixel >> 3;
+    const SwizzleBlockFunc swizzle_block = get_block_funcs(bytes_per_pixel).swizzle;
+    if (!swizzle_block || !can_use_swizzled_blocks(width, height)) {
+        for (uint16_t y = 0; y < height; y++) {
+            for (uint16_t x = 0; x < width; x++)
+                memcpy(dest + encode_morton(x, y, width, height) * bytes_per_pixel, src + (y * width + x) * bytes_per_pixel, bytes_per_pixel);
+        }
+        return;
+    }
+
+    for_each_swizzled_block(width, height, bytes_per_pixel, [&](size_t linear_offset, size_t pitch, uint32_t swizzled_offset) {
+        swizzle_block(dest + swizzled_offset, src + linear_offset, pitch);
+    });
+}
+
+// Calls f(linear offset, tiled offset, size) in bytes for each row of each 32x32 tile of the texture
+template <typename F>
+static void for_each_tile_row(const uint16_t width, const uint16_t height, const uint32_t bytes_per_pixel, F f) {
+    const uint32_t width_in_tiles = (width + 31) >> 5;
+    const size_t pitch = static_cast<size_t>(width) * bytes_per_pixel;
+
+    for (uint32_t y = 0; y < height; y++) {
+        const size_t tile_row_offset = (((static_cast<size_t>(width_in_tiles) * (y >> 5)) << 10) | ((y & 31) << 5)) * bytes_per_pixel;
+        for (uint32_t tile_x = 0; tile_x < width_in_tiles; tile_x++) {
+            const uint32_t texels = std::min<uint32_t>(32, width - tile_x * 32);
+            f(y * pitch + tile_x * 32 * bytes_per_pixel, tile_row_offset + (static_cast<size_t>(tile_x) << 10) * bytes_per_pixel, texels * bytes_per_pixel);
+        }
+    }
+}
+
+void tiled_texture_to_linear_texture(uint8_t *dest, const uint8_t *src, uint16_t width, uint16_t height, uint8_t bits_per_pixel) {
+    // 32x32 block is assembled to tiled.
+    if (bits_per_pixel % 8 != 0) {
+        // Don't support yet
+        return;
+    }
+
+    // each row of a tile is contiguous in the tiled texture
+    for_each_tile_row(width, height, bits_per_pixel >> 3, [&](size_t linear_offset, size_t tiled_offset, size_t size) {
+        memcpy(dest + linear_offset, src + tiled_offset, size);
+    });
+}
+
+void linear_texture_to_tiled_texture(uint8_t *dest, const uint8_t *src, uint16_t width, uint16_t height, uint8_t bits_per_pixel) {
+    if (bits_per_pixel % 8 != 0) {
+        // Don't support yet
+        return;
+    }
+
+    for_each_tile_row(width, height, bits_per_pixel >> 3, [&](size_t linear_offset, size_t tiled_offset, size_t size) {
+        memcpy(dest + tiled_offset, src + linear_offset, size);
+    });
+}
+
+} // namespace renderer::texture
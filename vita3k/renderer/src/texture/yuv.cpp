@@ -27,9 +27,10 @@ extern "C" {
 
 namespace renderer::texture {
 
-static SwsContext *s_render_sws_context{};
-static size_t res[2] = { 0, 0 };
-static bool is_yuv_p3 = false;
+// textures can be decoded on multiple worker threads at the same time, each one gets its own context
+static thread_local SwsContext *s_render_sws_context{};
+static thread_local size_t res[2] = { 0, 0 };
+static thread_local bool is_yuv_p3 = false;
 static SwsContext *get_sws_context(size_t width, size_t height, bool is_p3) {
     bool recreate = false;
     if (res[0] != width || res[1] != height || is_yuv_p3 != is_p3) {
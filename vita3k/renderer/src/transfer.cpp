@@ -27,36 +27,98 @@
 // keywords.h must be after tracy.h for msvc compiler
 #include <util/keywords.h>
 
+#include <vector>
+
 namespace renderer {
 
+// The offset in texels of (x, y) in an image is column_offsets[x] + row_offsets[y] (bitwise or for swizzled images)
+template <typename T, SceGxmTransferType type>
+static void compute_transfer_offsets(const SceGxmTransferImage &img, std::vector<int32_t> &column_offsets, std::vector<int32_t> &row_offsets, uint32_t width, uint32_t height) {
+    const int32_t stride_pixel = img.stride / sizeof(T);
+    column_offsets.resize(width);
+    row_offsets.resize(height);
+
+    for (uint32_t dx = 0; dx < width; dx++) {
+        const uint32_t x = img.x + dx;
+        if constexpr (type == SCE_GXM_TRANSFER_LINEAR) {
+            column_offsets[dx] = x;
+        } else if constexpr (type == SCE_GXM_TRANSFER_TILED) {
+            // tiles are 32x32, you have the offset within the tile then the offset of the tile
+            column_offsets[dx] = (x / 32) * 1024 + (x % 32);
+        } else {
+            column_offsets[dx] = texture::encode_morton(x, 0, img.width, img.height);
+        }
+    }
+
+    for (uint32_t dy = 0; dy < height; dy++) {
+        const uint32_t y = img.y + dy;
+        if constexpr (type == SCE_GXM_TRANSFER_LINEAR) {
+            row_offsets[dy] = y * stride_pixel;
+        } else if constexpr (type == SCE_GXM_TRANSFER_TILED) {
+            row_offsets[dy] = (stride_pixel / 32) * (y / 32) * 1024 + (y % 32) * 32;
+        } else {
+            row_offsets[dy] = texture::encode_morton(0, y, img.width, img.height);
+        }
+    }
+}
+
+// Converts a whole image between the linear layout and the swizzled or tiled one, returns false if the copy is not one
+template <typename T, SceGxmTransferType src_type, SceGxmTransferType dst_type>
+static bool perform_transfer_layout_conversion(MemState &mem, const SceGxmTransferImage &src, const SceGxmTransferImage &dst) {
+    if (src.x != 0 || src.y != 0 || dst.x != 0 || dst.y != 0 || src.width != dst.width || src.height != dst.height)
+        return false;
+
+    const uint32_t width = src.width;
+    const uint32_t height = src.height;
+    const auto has_layout_stride = [&](const SceGxmTransferImage &img, SceGxmTransferType type) {
+        if (type == SCE_GXM_TRANSFER_LINEAR)
+            return img.stride == width * sizeof(T);
+        if (type == SCE_GXM_TRANSFER_TILED)
+            return img.stride / sizeof(T) / 32 == (width + 31) / 32;
+        return true;
+    };
+    if (width > UINT16_MAX || height > UINT16_MAX || !has_layout_stride(src, src_type) || !has_layout_stride(dst, dst_type))
+        return false;
+
+    uint8_t *dst_ptr = dst.address.cast<uint8_t>().get(mem);
+    const uint8_t *src_ptr = src.address.cast<uint8_t>().get(mem);
+    constexpr uint8_t bits_per_pixel = sizeof(T) * 8;
+    if constexpr (src_type == SCE_GXM_TRANSFER_SWIZZLED)
+        texture::swizzled_texture_to_linear_texture(dst_ptr, src_ptr, width, height, bits_per_pixel);
+    else if constexpr (src_type == SCE_GXM_TRANSFER_TILED)
+        texture::tiled_texture_to_linear_texture(dst_ptr, src_ptr, width, height, bits_per_pixel);
+    else if constexpr (dst_type == SCE_GXM_TRANSFER_SWIZZLED)
+        texture::linear_texture_to_swizzled_texture(dst_ptr, src_ptr, width, height, bits_per_pixel);
+    else
+        texture::linear_texture_to_tiled_texture(dst_ptr, src_ptr, width, height, bits_per_pixel);
+
+    return true;
+}
+
 template <typename T, SceGxmTransferColorKeyMode mode, SceGxmTransferType src_type, SceGxmTransferType dst_type>
 static void perform_transfer_copy_impl(MemState &mem, const SceGxmTransferImage &src, const SceGxmTransferImage &dst, uint32_t key_value, uint32_t key_mask) {
+    if constexpr (mode == SCE_GXM_TRANSFER_COLORKEY_NONE && src_type != dst_type && (src_type == SCE_GXM_TRANSFER_LINEAR || dst_type == SCE_GXM_TRANSFER_LINEAR)) {
+        if (perform_transfer_layout_conversion<T, src_type, dst_type>(mem, src, dst))
+            return;
+    }
+
     T *__restrict__ src_ptr = src.address.cast<T>().get(mem);
     T *__restrict__ dst_ptr = dst.address.cast<T>().get(mem);
 
-    auto compute_offset = [&](uint32_t dx, uint32_t dy, const SceGxmTransferImage &img, SceGxmTransferType type) -> int32_t {
-        const int32_t stride_pixel = img.stride / sizeof(T);
-        if (type == SCE_GXM_TRANSFER_LINEAR) {
-            return dy * stride_pixel + dx;
-        } else if (type == SCE_GXM_TRANSFER_TILED) {
-            // tiles are 32x32, you have the offset within the tile then the offset of the tile
-            const uint32_t texel_offset_in_tile = ((dy % 32) * 32) + (dx % 32);
-            const int32_t tile_address = (stride_pixel / 32) * (dy / 32) + (dx / 32);
+    // kept between transfers to avoid allocations
+    static thread_local std::vector<int32_t> src_columns, src_rows, dst_columns, dst_rows;
+    compute_transfer_offsets<T, src_type>(src, src_columns, src_rows, src.width, src.height);
+    compute_transfer_offsets<T, dst_type>(dst, dst_columns, dst_rows, src.width, src.height);
 
-            return tile_address * 1024 + texel_offset_in_tile;
-        } else {
-            return texture::encode_morton(dx, dy, img.width, img.height);
-        }
+    const auto combine = [](int32_t column_offset, int32_t row_offset, SceGxmTransferType type) -> int32_t {
+        return type == SCE_GXM_TRANSFER_SWIZZLED ? (column_offset | row_offset) : (column_offset + row_offset);
     };
 
-    for (uint32_t dx = 0; dx < src.width; dx++) {
-        for (uint32_t dy = 0; dy < src.height; dy++) {
-            // compute offset depending on the texture type used
-            // the function compute_offset gets inlined
-            uint32_t src_offset = compute_offset(src.x + dx, src.y + dy, src, src_type);
-            uint32_t dst_offset = compute_offset(dst.x + dx, dst.y + dy, dst, dst_type);
-
-            T value = src_ptr[src_offset];
+    for (uint32_t dy = 0; dy < src.height; dy++) {
+        const int32_t src_row = src_rows[dy];
+        const int32_t dst_row = dst_rows[dy];
+        for (uint32_t dx = 0; dx < src.width; dx++) {
+            T value = src_ptr[combine(src_columns[dx], src_row, src_type)];
             if constexpr (mode == SCE_GXM_TRANSFER_COLORKEY_PASS) {
                 if ((value & key_mask) != key_value)
                     continue;
@@ -65,7 +127,7 @@ static void perform_transfer_copy_impl(MemState &mem, const SceGxmTransferImage
                     continue;
             }
 
-            dst_ptr[dst_offset] = value;
+            dst_ptr[combine(dst_columns[dx], dst_row, dst_type)] = value;
         }
     }
 }
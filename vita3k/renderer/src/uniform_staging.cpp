@@ -0,0 +1,47 @@
+// Vita3K emulator project
+// Copyright (C) 2024 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <renderer/uniform_staging.h>
+
+#include <cstring>
+
+namespace renderer {
+
+void UniformStaging::write(uint32_t offset, const void *data, uint32_t size) {
+    if (content.size() < offset + size)
+        content.resize(offset + size);
+
+    // most draws of a scene use the same camera and light buffers
+    uint8_t *dest = content.data() + offset;
+    if (memcmp(dest, data, size) != 0) {
+        memcpy(dest, data, size);
+        dirty = true;
+    }
+}
+
+bool UniformStaging::needs_upload(uint32_t size) {
+    if (content.size() < size)
+        content.resize(size);
+
+    const bool upload = dirty || size != uploaded_size;
+    dirty = false;
+    uploaded_size = size;
+
+    return upload;
+}
+
+} // namespace renderer
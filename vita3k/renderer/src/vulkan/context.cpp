@@ -246,6 +246,11 @@ void VKContext::start_recording(bool first_in_scene) {
     prerender_cmd.begin(begin_info);
 
     is_recording = true;
+    // pushed descriptors and bindings are not kept between command buffers
+    last_frag_push_layout = nullptr;
+    bound_pipeline_layout = nullptr;
+    bound_vertex_stream_count = 0;
+    bound_index_buffer = nullptr;
 
     // set all the dynamic state here
     render_cmd.setViewport(0, viewport);
@@ -377,6 +382,8 @@ void VKContext::stop_render_pass() {
         return;
     }
 
+    flush_pending_draws();
+
     // do this before ending the render pass
     if (is_in_query) {
         render_cmd.endQuery(current_visibility_buffer->query_pool, current_query_idx);
@@ -388,6 +395,23 @@ void VKContext::stop_render_pass() {
     in_renderpass = false;
 }
 
+void VKContext::flush_pending_draws() {
+    if (pending_draws.empty())
+        return;
+
+    if (pending_draws.size() == 1) {
+        const vk::DrawIndexedIndirectCommand &draw = pending_draws[0];
+        render_cmd.drawIndexed(draw.indexCount, draw.instanceCount, draw.firstIndex, draw.vertexOffset, draw.firstInstance);
+    } else {
+        const uint32_t draw_count = static_cast<uint32_t>(pending_draws.size());
+        indirect_draw_ring_buffer.allocate(prerender_cmd, draw_count * sizeof(vk::DrawIndexedIndirectCommand), pending_draws.data());
+        render_cmd.drawIndexedIndirect(indirect_draw_ring_buffer.handle(), indirect_draw_ring_buffer.data_offset, draw_count, sizeof(vk::DrawIndexedIndirectCommand));
+        state.frame_stats.merged_draws += draw_count - 1;
+    }
+
+    pending_draws.clear();
+}
+
 void VKContext::stop_recording(const SceGxmNotification &notif1, const SceGxmNotification &notif2, bool submit) {
     if (!is_recording) {
         LOG_ERROR("Stopping recording while not recording");
@@ -461,10 +485,7 @@ void VKContext::stop_recording(const SceGxmNotification &notif1, const SceGxmNot
     vk::Fence fence = next_fence;
     next_fence = nullptr;
 
-    vk::SubmitInfo submit_info{};
-    submit_info.setCommandBuffers(cmdbuffers_to_submit);
-
-    state.general_queue.submit(submit_info, fence);
+    state.submit_scene(std::move(cmdbuffers_to_submit), fence);
     cmdbuffers_to_submit.clear();
     state.frame().rendered_fences.push_back(fence);
 
@@ -580,6 +601,8 @@ void new_frame(VKContext &context) {
     for (int i = 0; i < 16; i++) {
         frame.vert_descriptors[i].descriptors_idx = 0;
         frame.frag_descriptors[i].descriptors_idx = 0;
+        frame.vert_descriptors[i].written_sets.clear();
+        frame.frag_descriptors[i].written_sets.clear();
     }
     frame.color_descriptor.descriptors_idx = 0;
 
@@ -33,6 +33,9 @@
 
 #include <SDL.h>
 
+#include <algorithm>
+#include <memory>
+
 // don't use the dispatch version, because we always hash a small amount
 // with a known size
 #define XXH_INLINE_ALL
@@ -43,18 +46,26 @@ namespace renderer::vulkan {
 // Size of the record containing what is needed for the pipeline construction (what is after is dynamic state)
 constexpr size_t record_pipeline_len = offsetof(GxmRecordState, vertex_streams);
 
+// value of a pipeline queued by prewarm_pipelines which has not been created yet
+static const vk::Pipeline pipeline_prewarming = std::bit_cast<vk::Pipeline, uint64_t>(~1ULL);
+
 // structure containing everything needed to compile a pipeline
 struct CompileRequest {
     // iterator to the pipeline location
     vk::Pipeline *pipeline;
+    uint64_t hash;
 
     // this is everything we need to compile the shader on another thread (as the original data will change)
     SceGxmPrimitiveType type;
     vk::RenderPass render_pass;
+    RenderPassKey render_pass_key;
     SceGxmVertexProgram *vertex_program_gxm;
     SceGxmFragmentProgram *fragment_program_gxm;
     shader::Hints hints;
 
+    // if set, the pipeline is compiled from its entry in prewarm_pending and the gxm programs are not used
+    bool prewarm = false;
+
     // the content of the record useful for the pipeline creation
     alignas(8) uint8_t record_data[record_pipeline_len];
 
@@ -176,6 +187,9 @@ void PipelineCache::init(bool support_rasterized_order_access) {
                 .bindingCount = i,
                 .pBindings = layout_bindings.data()
             };
+            // only one set of a pipeline layout can be pushed, use it for the fragment textures which change the most
+            if (state.support_push_descriptor)
+                descriptor_info.flags = vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR;
             fragment_textures_layout[i] = state.device.createDescriptorSetLayout(descriptor_info);
         }
     }
@@ -273,7 +287,11 @@ void PipelineCache::set_async_compilation(bool enable) {
 }
 
 // magic number put at the beginning of the pipeline cache file
-constexpr uint32_t pipeline_cache_magic = 0xBEEF4321;
+// increase it when the way pipelines are hashed changes
+constexpr uint32_t pipeline_cache_magic = 0xBEEF4323;
+
+// the pipeline keys are saved without the unused bindings and attributes
+constexpr size_t pipeline_key_fixed_size = offsetof(PipelineKey, bindings);
 
 void PipelineCache::read_pipeline_cache() {
     const std::string pipeline_cache_name = fmt::format("pipeline-cache-vk{}.dat", shader::CURRENT_VERSION);
@@ -307,7 +325,6 @@ void PipelineCache::read_pipeline_cache() {
         pipeline_cache_file.close();
         return;
     }
-    pipeline_size -= hashes_size;
 
     // insert hashes with null pipeline
     for (size_t i = 0; i < nb_hashes; i++) {
@@ -316,6 +333,31 @@ void PipelineCache::read_pipeline_cache() {
         pipelines[hash] = nullptr;
     }
 
+    // then the keys needed to compile these pipelines at boot
+    size_t nb_keys = 0;
+    read_integer(nb_keys);
+    for (size_t i = 0; i < nb_keys && pipeline_cache_file; i++) {
+        uint64_t hash;
+        read_integer(hash);
+        PipelineKey key{};
+        pipeline_cache_file.read(reinterpret_cast<char *>(&key), pipeline_key_fixed_size);
+        if (!pipeline_cache_file || key.nb_bindings > PipelineKey::MAX_BINDINGS || key.nb_attributes > PipelineKey::MAX_ATTRIBUTES)
+            break;
+
+        pipeline_cache_file.read(reinterpret_cast<char *>(key.bindings.data()), key.nb_bindings * sizeof(vk::VertexInputBindingDescription));
+        pipeline_cache_file.read(reinterpret_cast<char *>(key.attributes.data()), key.nb_attributes * sizeof(vk::VertexInputAttributeDescription));
+        pipeline_keys[hash] = key;
+    }
+
+    if (!pipeline_cache_file) {
+        LOG_WARN("Pipeline cache is corrupted, ignoring it.");
+        pipelines.clear();
+        pipeline_keys.clear();
+        pipeline_cache_file.close();
+        return;
+    }
+    pipeline_size -= static_cast<size_t>(pipeline_cache_file.tellg());
+
     std::vector<char> pipeline_data(pipeline_size);
     pipeline_cache_file.read(pipeline_data.data(), pipeline_size);
     pipeline_cache_file.close();
@@ -364,6 +406,18 @@ void PipelineCache::save_pipeline_cache() {
         write_integer(hash);
     }
 
+    // then the keys of the pipelines we know how to compile without the gxm programs
+    {
+        std::lock_guard<std::mutex> guard(pipeline_keys_mutex);
+        write_integer(pipeline_keys.size());
+        for (const auto &[hash, key] : pipeline_keys) {
+            write_integer(hash);
+            pipeline_cache_file.write(reinterpret_cast<const char *>(&key), pipeline_key_fixed_size);
+            pipeline_cache_file.write(reinterpret_cast<const char *>(key.bindings.data()), key.nb_bindings * sizeof(vk::VertexInputBindingDescription));
+            pipeline_cache_file.write(reinterpret_cast<const char *>(key.attributes.data()), key.nb_attributes * sizeof(vk::VertexInputAttributeDescription));
+        }
+    }
+
     // then save the cache
     pipeline_cache_file.write(reinterpret_cast<const char *>(pipeline_data.data()), pipeline_data.size());
     pipeline_cache_file.close();
@@ -414,7 +468,7 @@ vk::PipelineShaderStageCreateInfo PipelineCache::retrieve_shader(const SceGxmPro
     LOG_INFO("Generating vulkan spv shader {}", hash_text);
     const std::string shader_version = fmt::format("vk{}", shader::CURRENT_VERSION);
 
-    shader::usse::SpirvCode source = load_spirv_shader(*program, state.features, true, hints, maskupdate, state.shaders_path, state.shaders_log_path, shader_version, true);
+    shader::usse::SpirvCode source = load_spirv_shader(*program, hash, state.features, true, hints, maskupdate, state.shader_pack, state.shaders_log_path, shader_version, true);
 
     vk::ShaderModuleCreateInfo shader_info{
         .codeSize = sizeof(uint32_t) * source.size(),
@@ -566,9 +620,17 @@ vk::RenderPass PipelineCache::retrieve_render_pass(vk::Format format, bool force
         pass_info.setDependencyCount(2);
     }
 
-    render_passes_map[format] = state.device.createRenderPass(pass_info);
+    const vk::RenderPass render_pass = state.device.createRenderPass(pass_info);
+    render_passes_map[format] = render_pass;
+    render_pass_keys[render_pass] = RenderPassKey{
+        .format = format,
+        .force_load = force_load,
+        .force_store = force_store,
+        .is_color_transient = is_color_transient,
+        .no_color = no_color
+    };
 
-    return render_passes_map[format];
+    return render_pass;
 }
 
 vk::PipelineVertexInputStateCreateInfo PipelineCache::get_vertex_input_state(const SceGxmVertexProgram &vertex_program, MemState &mem) {
@@ -686,6 +748,15 @@ vk::PipelineVertexInputStateCreateInfo PipelineCache::get_vertex_input_state(con
     return vertex_input;
 }
 
+static vk::PipelineVertexInputStateCreateInfo get_key_vertex_input(const PipelineKey &key) {
+    return vk::PipelineVertexInputStateCreateInfo{
+        .vertexBindingDescriptionCount = key.nb_bindings,
+        .pVertexBindingDescriptions = key.bindings.data(),
+        .vertexAttributeDescriptionCount = key.nb_attributes,
+        .pVertexAttributeDescriptions = key.attributes.data()
+    };
+}
+
 void PipelineCache::compiler_thread(MemState &mem) {
     moodycamel::ConsumerToken consumer_token(pipeline_compile_queue);
 
@@ -698,7 +769,32 @@ void PipelineCache::compiler_thread(MemState &mem) {
             // use this as an instruction to stop the thread
             break;
 
-        vk::Pipeline pipeline = compile_pipeline(request->type, request->render_pass, *request->vertex_program_gxm, *request->fragment_program_gxm, *request->get_record(), request->hints, mem);
+        if (request->prewarm) {
+            std::unique_lock<std::mutex> lock(prewarm_mutex);
+            auto node = prewarm_pending.extract(request->hash);
+            lock.unlock();
+
+            // otherwise the render thread needed it first and took it
+            if (!node.empty()) {
+                const PrewarmRequest &prewarm = node.mapped();
+                const vk::Pipeline pipeline = create_pipeline(prewarm.key, prewarm.render_pass, get_key_vertex_input(prewarm.key), prewarm.vertex_shader, prewarm.fragment_shader);
+
+                lock.lock();
+                *request->pipeline = pipeline;
+                lock.unlock();
+                prewarm_cond.notify_all();
+
+                const uint32_t nb_done = ++prewarm_pipelines_done;
+                if (nb_done == prewarm_pipelines_total)
+                    LOG_INFO("Pipelines pre-warmed: {}/{}", nb_done, prewarm_pipelines_total.load());
+                state.shaders_count_compiled++;
+            }
+
+            delete request;
+            continue;
+        }
+
+        vk::Pipeline pipeline = compile_pipeline(request->hash, request->type, request->render_pass, request->render_pass_key, *request->vertex_program_gxm, *request->fragment_program_gxm, *request->get_record(), request->hints, mem);
         *request->pipeline = pipeline;
 
         request->vertex_program_gxm->compile_threads_on.fetch_sub(1, std::memory_order_release);
@@ -722,35 +818,71 @@ static vk::StencilOpState convert_op_state(const GxmStencilStateOp &state) {
     };
 }
 
-vk::Pipeline PipelineCache::compile_pipeline(SceGxmPrimitiveType type, vk::RenderPass render_pass, const SceGxmVertexProgram &vertex_program_gxm, const SceGxmFragmentProgram &fragment_program_gxm, const GxmRecordState &record, const shader::Hints &hints, MemState &mem) {
+bool PipelineCache::fill_pipeline_key(PipelineKey &key, SceGxmPrimitiveType type, const RenderPassKey &render_pass_key, const SceGxmVertexProgram &vertex_program_gxm, const SceGxmFragmentProgram &fragment_program_gxm, const GxmRecordState &record, const vk::PipelineVertexInputStateCreateInfo &vertex_input, MemState &mem) {
     const VertexProgram &vertex_program = *reinterpret_cast<VertexProgram *>(
         vertex_program_gxm.renderer_data.get());
     const SceGxmProgram *gxm_fragment_shader = fragment_program_gxm.program.get(mem);
     const VKFragmentProgram &fragment_program = *reinterpret_cast<VKFragmentProgram *>(
         fragment_program_gxm.renderer_data.get());
 
-    // the vertex input state must be computed before shader are retrieved in case symbols are stripped
-    const vk::PipelineVertexInputStateCreateInfo vertex_input = get_vertex_input_state(vertex_program_gxm, mem);
+    key.vertex_hash = vertex_program.hash;
+    key.fragment_hash = fragment_program.hash;
+    key.render_pass = render_pass_key;
+    key.topology = translate_primitive(type);
 
-    const vk::PipelineShaderStageCreateInfo vertex_shader = retrieve_shader(vertex_program_gxm.program.get(mem), vertex_program.hash, true, fragment_program_gxm.is_maskupdate, mem, hints);
-    const vk::PipelineShaderStageCreateInfo fragment_shader = retrieve_shader(gxm_fragment_shader, fragment_program.hash, false, fragment_program_gxm.is_maskupdate, mem, hints);
-    const vk::PipelineShaderStageCreateInfo shader_stages[] = { vertex_shader, fragment_shader };
     // disable the fragment shader if gxm asks us to
-    const bool is_fragment_disabled = record.front_side_fragment_program_mode == SCE_GXM_FRAGMENT_PROGRAM_DISABLED || gxm_fragment_shader->has_no_effect();
-    const uint32_t shader_stage_count = is_fragment_disabled ? 1U : 2U;
-
-    const vk::PipelineInputAssemblyStateCreateInfo input_assembly{
-        .topology = translate_primitive(type)
-    };
+    key.is_fragment_disabled = record.front_side_fragment_program_mode == SCE_GXM_FRAGMENT_PROGRAM_DISABLED || gxm_fragment_shader->has_no_effect();
+    key.is_frag_color_used = gxm_fragment_shader->is_frag_color_used();
 
     const bool two_sided = (record.two_sided == SCE_GXM_TWO_SIDED_ENABLED);
+    key.polygon_mode = translate_polygon_mode(record.front_polygon_mode);
+    key.cull_mode = translate_cull_mode(record.cull_mode);
+    key.depth_write = (record.front_depth_write_mode == SCE_GXM_DEPTH_WRITE_ENABLED);
+    key.depth_func = translate_depth_func(record.front_depth_func);
+    key.front_stencil = convert_op_state(record.front_stencil_state_op);
+    key.back_stencil = convert_op_state(two_sided ? record.back_stencil_state_op : record.front_stencil_state_op);
+
+    const bool use_shader_interlock = state.features.support_shader_interlock && key.is_frag_color_used;
+    const bool frag_has_no_output = static_cast<bool>(gxm_fragment_shader->program_flags & SCE_GXM_PROGRAM_FLAG_OUTPUT_UNDEFINED);
+    if (key.is_fragment_disabled || frag_has_no_output || use_shader_interlock) {
+        // The write mask must be empty as the lack of a fragment shader results in undefined values
+        key.blending = vk::PipelineColorBlendAttachmentState{
+            .blendEnable = VK_FALSE,
+            .colorWriteMask = vk::ColorComponentFlags()
+        };
+    } else {
+        key.blending = fragment_program.blending;
+    }
 
-    const bool use_shader_interlock = state.features.support_shader_interlock && gxm_fragment_shader->is_frag_color_used();
+    key.vertex_texture_count = vertex_program.texture_count;
+    key.fragment_texture_count = fragment_program.texture_count;
+
+    if (vertex_input.vertexBindingDescriptionCount > PipelineKey::MAX_BINDINGS || vertex_input.vertexAttributeDescriptionCount > PipelineKey::MAX_ATTRIBUTES)
+        return false;
+
+    key.nb_bindings = static_cast<uint8_t>(vertex_input.vertexBindingDescriptionCount);
+    std::copy_n(vertex_input.pVertexBindingDescriptions, key.nb_bindings, key.bindings.begin());
+    key.nb_attributes = static_cast<uint8_t>(vertex_input.vertexAttributeDescriptionCount);
+    std::copy_n(vertex_input.pVertexAttributeDescriptions, key.nb_attributes, key.attributes.begin());
+
+    return true;
+}
+
+vk::Pipeline PipelineCache::create_pipeline(const PipelineKey &key, vk::RenderPass render_pass, const vk::PipelineVertexInputStateCreateInfo &vertex_input, vk::ShaderModule vertex_shader, vk::ShaderModule fragment_shader) {
+    const vk::PipelineShaderStageCreateInfo shader_stages[] = {
+        { .stage = vk::ShaderStageFlagBits::eVertex, .module = vertex_shader, .pName = "main_vs" },
+        { .stage = vk::ShaderStageFlagBits::eFragment, .module = fragment_shader, .pName = "main_fs" }
+    };
+    const uint32_t shader_stage_count = key.is_fragment_disabled ? 1U : 2U;
+
+    const vk::PipelineInputAssemblyStateCreateInfo input_assembly{
+        .topology = key.topology
+    };
 
     const vk::PipelineRasterizationStateCreateInfo rasterizer{
         .depthClampEnable = state.physical_device_features.depthClamp,
-        .polygonMode = translate_polygon_mode(record.front_polygon_mode),
-        .cullMode = translate_cull_mode(record.cull_mode),
+        .polygonMode = key.polygon_mode,
+        .cullMode = key.cull_mode,
         // front face is always counter clockwise
         .frontFace = vk::FrontFace::eCounterClockwise,
         .depthBiasEnable = VK_TRUE,
@@ -763,32 +895,20 @@ vk::Pipeline PipelineCache::compile_pipeline(SceGxmPrimitiveType type, vk::Rende
     // on a tiled renderer
     const vk::PipelineDepthStencilStateCreateInfo ds_info{
         .depthTestEnable = VK_TRUE,
-        .depthWriteEnable = (record.front_depth_write_mode == SCE_GXM_DEPTH_WRITE_ENABLED),
-        .depthCompareOp = translate_depth_func(record.front_depth_func),
+        .depthWriteEnable = key.depth_write,
+        .depthCompareOp = key.depth_func,
         .depthBoundsTestEnable = VK_FALSE,
         .stencilTestEnable = VK_TRUE,
-        .front = convert_op_state(record.front_stencil_state_op),
-        .back = convert_op_state(two_sided ? record.back_stencil_state_op : record.front_stencil_state_op)
+        .front = key.front_stencil,
+        .back = key.back_stencil
     };
 
     vk::PipelineColorBlendStateCreateInfo color_blending{};
-    if (support_coherent_framebuffer_fetch && gxm_fragment_shader->is_frag_color_used())
+    if (support_coherent_framebuffer_fetch && key.is_frag_color_used)
         color_blending.flags = vk::PipelineColorBlendStateCreateFlagBits::eRasterizationOrderAttachmentAccessEXT;
+    color_blending.setAttachments(key.blending);
 
-    const bool frag_has_no_output = static_cast<bool>(gxm_fragment_shader->program_flags & SCE_GXM_PROGRAM_FLAG_OUTPUT_UNDEFINED);
-    if (is_fragment_disabled || frag_has_no_output || use_shader_interlock) {
-        // The write mask must be empty as the lack of a fragment shader results in undefined values
-        static const vk::PipelineColorBlendAttachmentState blending = {
-            .blendEnable = VK_FALSE,
-            .colorWriteMask = vk::ColorComponentFlags()
-        };
-        color_blending.setAttachments(blending);
-    } else {
-        const vk::PipelineColorBlendAttachmentState &blending = fragment_program.blending;
-        color_blending.setAttachments(blending);
-    }
-
-    vk::PipelineLayout pipeline_layout = pipeline_layouts[vertex_program.texture_count][fragment_program.texture_count];
+    vk::PipelineLayout pipeline_layout = pipeline_layouts[key.vertex_texture_count][key.fragment_texture_count];
 
     // all of these can be changed at any time using the vita graphics api (like opengl)
     // Because each one can take a lot of different values, it's better to set them as dynamic
@@ -837,6 +957,32 @@ vk::Pipeline PipelineCache::compile_pipeline(SceGxmPrimitiveType type, vk::Rende
     return result.value;
 }
 
+vk::Pipeline PipelineCache::compile_pipeline(uint64_t hash, SceGxmPrimitiveType type, vk::RenderPass render_pass, const RenderPassKey &render_pass_key, const SceGxmVertexProgram &vertex_program_gxm, const SceGxmFragmentProgram &fragment_program_gxm, const GxmRecordState &record, const shader::Hints &hints, MemState &mem) {
+    const VertexProgram &vertex_program = *reinterpret_cast<VertexProgram *>(
+        vertex_program_gxm.renderer_data.get());
+    const SceGxmProgram *gxm_fragment_shader = fragment_program_gxm.program.get(mem);
+    const VKFragmentProgram &fragment_program = *reinterpret_cast<VKFragmentProgram *>(
+        fragment_program_gxm.renderer_data.get());
+
+    // the vertex input state must be computed before shader are retrieved in case symbols are stripped
+    const vk::PipelineVertexInputStateCreateInfo vertex_input = get_vertex_input_state(vertex_program_gxm, mem);
+
+    PipelineKey key;
+    const bool has_key = fill_pipeline_key(key, type, render_pass_key, vertex_program_gxm, fragment_program_gxm, record, vertex_input, mem);
+
+    const vk::PipelineShaderStageCreateInfo vertex_shader = retrieve_shader(vertex_program_gxm.program.get(mem), vertex_program.hash, true, fragment_program_gxm.is_maskupdate, mem, hints);
+    const vk::PipelineShaderStageCreateInfo fragment_shader = retrieve_shader(gxm_fragment_shader, fragment_program.hash, false, fragment_program_gxm.is_maskupdate, mem, hints);
+
+    const vk::Pipeline pipeline = create_pipeline(key, render_pass, vertex_input, vertex_shader.module, fragment_shader.module);
+    if (pipeline && has_key) {
+        // record it so that it can be compiled at boot next time
+        std::lock_guard<std::mutex> guard(pipeline_keys_mutex);
+        pipeline_keys[hash] = key;
+    }
+
+    return pipeline;
+}
+
 vk::Pipeline PipelineCache::retrieve_pipeline(VKContext &context, SceGxmPrimitiveType &type, bool consider_for_async, MemState &mem) {
     const GxmRecordState &record = context.record;
     // get the hash of the current context
@@ -862,6 +1008,10 @@ vk::Pipeline PipelineCache::retrieve_pipeline(VKContext &context, SceGxmPrimitiv
 
     auto it = pipelines.find(key);
     if (it != pipelines.end()) {
+        if (it->second == pipeline_prewarming)
+            // if this fails, it is compiled below like any pipeline of the cache
+            take_prewarmed_pipeline(key, it->second);
+
         if (it->second != nullptr) {
             if (it->second == pipeline_compiling)
                 // pipeline is still compiling
@@ -879,6 +1029,7 @@ vk::Pipeline PipelineCache::retrieve_pipeline(VKContext &context, SceGxmPrimitiv
     const SceGxmProgram *gxm_fragment_shader = fragment_program_gxm.program.get(mem);
     const bool use_shader_interlock = state.features.support_shader_interlock && gxm_fragment_shader->is_frag_color_used();
     const vk::RenderPass render_pass = use_shader_interlock ? context.current_shader_interlock_pass : context.current_render_pass;
+    const RenderPassKey &render_pass_key = render_pass_keys[render_pass];
     // update the shader hints
     context.shader_hints.color_format = record.color_surface.colorFormat;
     context.shader_hints.attributes = &vertex_program_gxm.attributes;
@@ -891,8 +1042,10 @@ vk::Pipeline PipelineCache::retrieve_pipeline(VKContext &context, SceGxmPrimitiv
         CompileRequest *request = new CompileRequest;
         *request = {
             .pipeline = &it->second,
+            .hash = key,
             .type = type,
             .render_pass = render_pass,
+            .render_pass_key = render_pass_key,
             .vertex_program_gxm = &vertex_program_gxm,
             .fragment_program_gxm = &fragment_program_gxm,
             .hints = context.shader_hints
@@ -909,7 +1062,7 @@ vk::Pipeline PipelineCache::retrieve_pipeline(VKContext &context, SceGxmPrimitiv
         return nullptr;
     } else {
         // can't wait, compile it right now
-        vk::Pipeline result = compile_pipeline(type, render_pass, vertex_program_gxm, fragment_program_gxm, record, context.shader_hints, mem);
+        vk::Pipeline result = compile_pipeline(key, type, render_pass, render_pass_key, vertex_program_gxm, fragment_program_gxm, record, context.shader_hints, mem);
 
         const auto time_s = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
         next_pipeline_cache_save = time_s + pipeline_cache_save_delay;
@@ -923,6 +1076,30 @@ vk::Pipeline PipelineCache::retrieve_pipeline(VKContext &context, SceGxmPrimitiv
     }
 }
 
+void PipelineCache::take_prewarmed_pipeline(uint64_t hash, vk::Pipeline &pipeline) {
+    std::unique_lock<std::mutex> lock(prewarm_mutex);
+    auto node = prewarm_pending.extract(hash);
+    if (node.empty()) {
+        // a compiler thread is already creating it
+        prewarm_cond.wait(lock, [&] { return pipeline != pipeline_prewarming; });
+        return;
+    }
+    lock.unlock();
+
+    // its request is still in the queue, the compiler thread will skip it
+    const PrewarmRequest &prewarm = node.mapped();
+    const vk::Pipeline result = create_pipeline(prewarm.key, prewarm.render_pass, get_key_vertex_input(prewarm.key), prewarm.vertex_shader, prewarm.fragment_shader);
+
+    lock.lock();
+    pipeline = result;
+    lock.unlock();
+
+    const uint32_t nb_done = ++prewarm_pipelines_done;
+    if (nb_done == prewarm_pipelines_total)
+        LOG_INFO("Pipelines pre-warmed: {}/{}", nb_done, prewarm_pipelines_total.load());
+    state.shaders_count_compiled++;
+}
+
 vk::ShaderModule PipelineCache::precompile_shader(const Sha256Hash &hash, bool search_first) {
     if (search_first) {
         // happens while loading the thread, no parallel access so no need for a mutex
@@ -931,13 +1108,7 @@ vk::ShaderModule PipelineCache::precompile_shader(const Sha256Hash &hash, bool s
             return it->second;
     }
 
-    if (!fs::exists(state.shaders_path) || fs::is_empty(state.shaders_path))
-        return nullptr;
-
-    Sha256Hash shader_hash;
-    memcpy(shader_hash.data(), hash.data(), sizeof(Sha256Hash));
-    const std::string shader_file_name = fmt::format("vk{}-{}.spv", shader::CURRENT_VERSION, hex_string(shader_hash));
-    const std::vector<uint32_t> source = renderer::pre_load_shader_spirv(state.shaders_path / shader_file_name);
+    const std::vector<uint32_t> source = state.shader_pack.load_spirv(hash, static_cast<uint32_t>(shader::Target::SpirVVulkan));
 
     if (source.empty())
         return nullptr;
@@ -955,4 +1126,87 @@ vk::ShaderModule PipelineCache::precompile_shader(const Sha256Hash &hash, bool s
 
     return shader;
 }
+
+void PipelineCache::prewarm_pipelines() {
+    if (!use_async_compilation) {
+        // there is no worker thread to compile them in the background
+        return;
+    }
+
+    // a saved key can use a format the current gpu does not support as a vertex input
+    std::map<vk::Format, bool> supported_attribute_formats;
+    auto is_attribute_format_supported = [&](vk::Format format) {
+        auto it = supported_attribute_formats.find(format);
+        if (it == supported_attribute_formats.end()) {
+            const vk::FormatProperties properties = state.physical_device.getFormatProperties(format);
+            it = supported_attribute_formats.emplace(format, static_cast<bool>(properties.bufferFeatures & vk::FormatFeatureFlagBits::eVertexBuffer)).first;
+        }
+        return it->second;
+    };
+
+    auto get_shader = [&](const Sha256Hash &hash) {
+        {
+            std::lock_guard<std::mutex> guard(shaders_mutex);
+            auto it = shaders.find(hash);
+            if (it != shaders.end())
+                return it->second;
+        }
+        return precompile_shader(hash, false);
+    };
+
+    std::vector<std::pair<uint64_t, PipelineKey>> keys;
+    {
+        std::lock_guard<std::mutex> guard(pipeline_keys_mutex);
+        keys.assign(pipeline_keys.begin(), pipeline_keys.end());
+    }
+
+    std::vector<CompileRequest *> requests;
+    for (const auto &[hash, key] : keys) {
+        auto it = pipelines.find(hash);
+        if (it == pipelines.end() || it->second != nullptr)
+            continue;
+
+        if (key.vertex_texture_count > 16 || key.fragment_texture_count > 16)
+            continue;
+
+        const bool attributes_supported = std::all_of(key.attributes.begin(), key.attributes.begin() + key.nb_attributes, [&](const vk::VertexInputAttributeDescription &attribute) {
+            return is_attribute_format_supported(attribute.format);
+        });
+        if (!attributes_supported)
+            continue;
+
+        // only use the shaders from the shader cache, generating them requires the gxm programs
+        const vk::ShaderModule vertex_shader = get_shader(key.vertex_hash);
+        const vk::ShaderModule fragment_shader = get_shader(key.fragment_hash);
+        if (!vertex_shader || (!fragment_shader && !key.is_fragment_disabled))
+            continue;
+
+        const RenderPassKey &pass = key.render_pass;
+        const vk::RenderPass render_pass = retrieve_render_pass(pass.format, pass.force_load, pass.force_store, pass.is_color_transient, pass.no_color);
+
+        CompileRequest *request = new CompileRequest;
+        *request = {
+            .pipeline = &it->second,
+            .hash = hash,
+            .render_pass = render_pass,
+            .render_pass_key = pass,
+            .prewarm = true
+        };
+        {
+            std::lock_guard<std::mutex> guard(prewarm_mutex);
+            prewarm_pending[hash] = PrewarmRequest{ key, render_pass, vertex_shader, fragment_shader };
+        }
+        it->second = pipeline_prewarming;
+        requests.push_back(request);
+    }
+
+    if (requests.empty())
+        return;
+
+    prewarm_pipelines_done = 0;
+    prewarm_pipelines_total = static_cast<uint32_t>(requests.size());
+    LOG_INFO("Pre-warming {} pipelines in the background", requests.size());
+    for (CompileRequest *request : requests)
+        pipeline_compile_queue.enqueue(pipeline_compile_queue_token, request);
+}
 } // namespace renderer::vulkan
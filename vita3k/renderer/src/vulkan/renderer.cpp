@@ -488,6 +488,7 @@ bool VKState::create(SDL_Window *window, std::unique_ptr<renderer::State> &state
 
         // use these features (because they are used by the vita GPU) if they are available
         vk::PhysicalDeviceFeatures enabled_features{
+            .multiDrawIndirect = physical_device_features.multiDrawIndirect,
             .depthClamp = physical_device_features.depthClamp,
             .fillModeNonSolid = physical_device_features.fillModeNonSolid,
             .wideLines = physical_device_features.wideLines,
@@ -531,6 +532,8 @@ bool VKState::create(SDL_Window *window, std::unique_ptr<renderer::State> &state
 #endif
             // used for coherent framebuffer fetch
             { VK_EXT_RASTERIZATION_ORDER_ATTACHMENT_ACCESS_EXTENSION_NAME, &support_rasterized_order_access },
+            // used to bind the fragment textures without allocating and updating descriptor sets
+            { VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME, &support_push_descriptor },
 #ifdef ANDROID
             // dependencies of VK_ANDROID_external_memory_android_hardware_buffer
             { VK_KHR_BIND_MEMORY_2_EXTENSION_NAME, &temp_bool },
@@ -614,6 +617,10 @@ bool VKState::create(SDL_Window *window, std::unique_ptr<renderer::State> &state
             }
         }
 
+        if (physical_device_features.multiDrawIndirect)
+            // runs of draws sharing the same state are merged into a single indirect draw
+            max_draw_indirect_count = std::min<uint32_t>(physical_device_properties.limits.maxDrawIndirectCount, 1024);
+
         support_fsr &= static_cast<bool>(physical_device_features.shaderInt16);
         if (support_fsr) {
             // double check for FP16 support
@@ -691,6 +698,7 @@ bool VKState::create(SDL_Window *window, std::unique_ptr<renderer::State> &state
     // Get Queues
     general_queue = device.getQueue(general_family_index, 0);
     transfer_queue = device.getQueue(transfer_family_index, 0);
+    submit_thread.start(1);
 
     // Create Command Pools
     {
@@ -853,9 +861,12 @@ void VKState::late_init(const Config &cfg, const std::string_view game_id, MemSt
     pipeline_cache.init(support_rasterized_order_access);
 
     texture_cache.init(true, texture_folder(), game_id);
+    texture_cache.decoded_cache.init(cache_path / "textures" / std::string(game_id));
 }
 
 void VKState::cleanup() {
+    wait_for_submissions();
+    submit_thread.stop();
     device.waitIdle();
 
     screen_renderer.cleanup();
@@ -869,6 +880,24 @@ void VKState::cleanup() {
     instance.destroy();
 }
 
+void VKState::submit_scene(std::vector<vk::CommandBuffer> cmd_buffers, vk::Fence fence) {
+    last_submission = submit_thread.submit([this, cmd_buffers = std::move(cmd_buffers), fence]() {
+        vk::SubmitInfo submit_info{};
+        submit_info.setCommandBuffers(cmd_buffers);
+        try {
+            general_queue.submit(submit_info, fence);
+        } catch (vk::SystemError &err) {
+            LOG_ERROR("Could not submit the scene: {}", err.what());
+        }
+    });
+}
+
+void VKState::wait_for_submissions() {
+    // the submissions are done in order, so the last one being done means all of them are
+    if (last_submission.valid())
+        last_submission.get();
+}
+
 void VKState::render_frame(const SceFVector2 &viewport_pos, const SceFVector2 &viewport_size, DisplayState &display,
     const GxmState &gxm, MemState &mem) {
     // we are displaying this frame, wait for a new one
@@ -993,6 +1022,8 @@ int VKState::get_supported_filters() {
 }
 
 void VKState::set_screen_filter(const std::string_view &filter) {
+    // the previous filter waits for the device to be idle when destroyed
+    wait_for_submissions();
     if (filter == "FSR" && !support_fsr) {
         LOG_WARN("Trying to enable FSR but the GPU does not support it");
         screen_renderer.set_filter("");
@@ -1242,6 +1273,7 @@ void VKState::unmap_memory(MemState &mem, Ptr<void> address) {
     }
 
     // we need to wait in case the buffer is being used
+    wait_for_submissions();
     device.waitIdle();
 
     switch (mapping_method) {
@@ -1367,6 +1399,10 @@ void VKState::precompile_shader(const ShadersHash &hash) {
     LOG_INFO("Program Compiled {}/{}", programs_count_pre_compiled, shaders_cache_hashs.size());
 }
 
+void VKState::prewarm_pipelines() {
+    pipeline_cache.prewarm_pipelines();
+}
+
 void VKState::preclose_action() {
     // make sure we are in a game
     if (shaders_path.empty())
@@ -1392,6 +1428,10 @@ void VKState::set_turbo_mode(bool set) {
 BufferTrapping::BufferTrapping(VKState &state)
     : state(state) {}
 
+static bool is_buffer_dirty(const TrappedBuffer &buffer, const MemState &mem) {
+    return is_range_written(mem, buffer.tracked_addr, buffer.tracked_size, buffer.write_epoch);
+}
+
 TrappedBuffer *BufferTrapping::access_buffer(Address addr, uint32_t size, MemState &mem, bool always_trap, bool cover_everything) {
     const bool is_buffer_small = (size < 3 * KiB(4));
 
@@ -1420,7 +1460,7 @@ TrappedBuffer *BufferTrapping::access_buffer(Address addr, uint32_t size, MemSta
     if (it != trapped_buffers.end()) {
         // must check if everything match
         TrappedBuffer &buffer = it->second;
-        if (!buffer.dirty && buffer.size >= size)
+        if (buffer.size >= size && !is_buffer_dirty(buffer, mem))
             // nothing to change
             return &it->second;
     } else {
@@ -1433,14 +1473,13 @@ TrappedBuffer *BufferTrapping::access_buffer(Address addr, uint32_t size, MemSta
         auto next_it = it;
         next_it++;
         while (next_it != trapped_buffers.end() && next_it->first < addr + size) {
-            if (next_it->second.dirty)
+            if (is_buffer_dirty(next_it->second, mem))
                 next_it = trapped_buffers.erase(next_it);
             else
                 next_it++;
         }
     }
     it->second.size = size;
-    it->second.dirty = false;
     it->second.extra = ~0;
 
     if (is_new) {
@@ -1464,10 +1503,10 @@ TrappedBuffer *BufferTrapping::access_buffer(Address addr, uint32_t size, MemSta
         aligned_addr = align(addr, KiB(4));
         aligned_size = align_down(addr + size - aligned_addr, KiB(4));
     }
-    add_protect(mem, aligned_addr, aligned_size, MemPerm::ReadOnly, [it](Address addr, bool write) {
-        it->second.dirty = true;
-        return true;
-    });
+    // must be armed before the copy so that a concurrent write is not missed
+    it->second.tracked_addr = aligned_addr;
+    it->second.tracked_size = aligned_size;
+    it->second.write_epoch = track_writes(mem, aligned_addr, aligned_size);
 
     // copy back the data as it was non-existent or dirty
     memcpy(it->second.mapped_location, Ptr<void>(addr).get(mem), size);
@@ -26,6 +26,10 @@
 #include <util/align.h>
 #include <util/log.h>
 
+// the descriptor keys are small and have a known size
+#define XXH_INLINE_ALL
+#include <xxhash.h>
+
 namespace renderer::vulkan {
 
 void set_uniform_buffer(VKContext &context, MemState &mem, const ShaderProgram *program, const bool vertex_shader, const int block_num, const int size, Ptr<uint8_t> data) {
@@ -49,23 +53,8 @@ void set_uniform_buffer(VKContext &context, MemState &mem, const ShaderProgram *
         }
     } else {
         const uint32_t offset_start_upload = offset * 4;
-        if (vertex_shader) {
-            if (!context.vertex_uniform_storage_allocated) {
-                // Allocate a region for it. Don't worry though, when the shader program is changed
-                context.vertex_uniform_stream_ring_buffer.allocate(program->max_total_uniform_buffer_storage * 4);
-                context.vertex_uniform_storage_allocated = true;
-            }
-
-            context.vertex_uniform_stream_ring_buffer.copy(context.prerender_cmd, data_size_upload, data.get(mem), offset_start_upload);
-        } else {
-            if (!context.fragment_uniform_storage_allocated) {
-                // Allocate a region for it. Don't worry though, when the shader program is changed
-                context.fragment_uniform_stream_ring_buffer.allocate(program->max_total_uniform_buffer_storage * 4);
-                context.fragment_uniform_storage_allocated = true;
-            }
-
-            context.fragment_uniform_stream_ring_buffer.copy(context.prerender_cmd, data_size_upload, data.get(mem), offset_start_upload);
-        }
+        UniformStaging &staging = vertex_shader ? context.vertex_uniform_staging : context.fragment_uniform_staging;
+        staging.write(offset_start_upload, data.get(mem), data_size_upload);
     }
 }
 
@@ -165,6 +154,60 @@ static vk::DescriptorSet retrieve_descriptor(VKContext &context, bool is_vertex,
     return frame_descriptor.sets[frame_descriptor.descriptors_idx++];
 }
 
+// the ring buffer offset of the previous draw is kept if the uniform buffers did not change
+static void upload_uniform_storage(VKContext &context, UniformStaging &staging, vkutil::HostRingBuffer &ring_buffer, const uint32_t size) {
+    context.state.frame_stats.uniform_bytes_requested += size;
+    if (!staging.needs_upload(size))
+        return;
+
+    ring_buffer.allocate(context.prerender_cmd, size, staging.data());
+    context.state.frame_stats.uniform_bytes_uploaded += size;
+}
+
+size_t TextureDescriptorKeyHasher::operator()(const TextureDescriptorKey &key) const {
+    // hash the handles one by one, the padding of the image infos may not be initialized
+    std::array<uint64_t, 3 * 16> values;
+    for (size_t i = 0; i < key.images.size(); i++) {
+        values[3 * i] = std::bit_cast<uint64_t>(key.images[i].sampler);
+        values[3 * i + 1] = std::bit_cast<uint64_t>(key.images[i].imageView);
+        values[3 * i + 2] = static_cast<uint64_t>(key.images[i].imageLayout);
+    }
+    return XXH3_64bits(values.data(), sizeof(values));
+}
+
+// return a descriptor set containing the given textures, it is only written if no draw used the same textures during this frame
+static vk::DescriptorSet retrieve_texture_descriptor(VKContext &context, bool is_vertex, uint16_t textures_count, const vk::DescriptorImageInfo *textures) {
+    if (textures_count == 0)
+        return context.empty_set;
+
+    TextureDescriptorKey key;
+    std::copy_n(textures, textures_count, key.images.begin());
+
+    VKState &state = context.state;
+    FrameDescriptor &frame_descriptor = is_vertex ? state.frame().vert_descriptors[textures_count - 1] : state.frame().frag_descriptors[textures_count - 1];
+    auto it = frame_descriptor.written_sets.find(key);
+    if (it != frame_descriptor.written_sets.end())
+        return it->second;
+
+    const vk::DescriptorSet descriptor_set = retrieve_descriptor(context, is_vertex, textures_count);
+
+    std::array<vk::WriteDescriptorSet, 16> write_descrs;
+    for (uint32_t i = 0; i < textures_count; i++) {
+        write_descrs[i] = vk::WriteDescriptorSet{
+            .dstSet = descriptor_set,
+            .dstBinding = i,
+            .dstArrayElement = 0,
+            .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+        };
+        write_descrs[i].setImageInfo(textures[i]);
+    }
+    state.device.updateDescriptorSets(textures_count, write_descrs.data(), 0, nullptr);
+    state.frame_stats.descriptor_writes += textures_count;
+
+    frame_descriptor.written_sets.emplace(key, descriptor_set);
+    return descriptor_set;
+}
+
 static void draw_bind_descriptors(VKContext &context, MemState &mem) {
     VKState &state = context.state;
 
@@ -188,55 +231,35 @@ static void draw_bind_descriptors(VKContext &context, MemState &mem) {
     context.last_vert_texture_count = vertex_textures_count;
     context.last_frag_texture_count = fragment_texture_count;
 
-    {
-        int set_idx = 0;
-        if (need_vert_descr) {
-            context.last_vert_texture_descriptor = retrieve_descriptor(context, true, vertex_textures_count);
-        }
-        descriptors[2] = context.last_vert_texture_descriptor;
-
-        if (need_frag_descr) {
-            context.last_frag_texture_descriptor = retrieve_descriptor(context, false, fragment_texture_count);
-        }
-        descriptors[3] = context.last_frag_texture_descriptor;
-    }
-
-    // bind textures
-    std::array<vk::WriteDescriptorSet, 16> write_descrs;
     // some default sampler in case a slot has never been set and we read a slot with higher idx
-    vk::DescriptorImageInfo default_image_info{
+    const vk::DescriptorImageInfo default_image_info{
         .sampler = context.state.default_image.sampler,
         .imageView = context.state.default_image.view,
         .imageLayout = vk::ImageLayout::eGeneral
     };
+    const auto get_textures = [&](const vk::DescriptorImageInfo *bound_textures, uint16_t textures_count) {
+        std::array<vk::DescriptorImageInfo, 16> textures;
+        for (uint32_t i = 0; i < textures_count; i++)
+            textures[i] = bound_textures[i].sampler ? bound_textures[i] : default_image_info;
+        return textures;
+    };
 
-    // vertex
     if (need_vert_descr) {
-        for (uint32_t i = 0; i < vertex_textures_count; i++) {
-            write_descrs[i] = vk::WriteDescriptorSet{
-                .dstSet = descriptors[2],
-                .dstBinding = i,
-                .dstArrayElement = 0,
-                .descriptorType = vk::DescriptorType::eCombinedImageSampler,
-            };
-            write_descrs[i].setImageInfo(context.vertex_textures[i].sampler ? context.vertex_textures[i] : default_image_info);
-        }
-        state.device.updateDescriptorSets(vertex_textures_count, write_descrs.data(), 0, nullptr);
+        const auto textures = get_textures(context.vertex_textures, vertex_textures_count);
+        context.last_vert_texture_descriptor = retrieve_texture_descriptor(context, true, vertex_textures_count, textures.data());
     }
-
-    // fragment
-    if (need_frag_descr) {
-        for (uint32_t i = 0; i < fragment_texture_count; i++) {
-            write_descrs[i] = vk::WriteDescriptorSet{
-                .dstSet = descriptors[3],
-                .dstBinding = i,
-                .dstArrayElement = 0,
-                .descriptorType = vk::DescriptorType::eCombinedImageSampler,
-            };
-            write_descrs[i].setImageInfo(context.fragment_textures[i].sampler ? context.fragment_textures[i] : default_image_info);
-        }
-        state.device.updateDescriptorSets(fragment_texture_count, write_descrs.data(), 0, nullptr);
+    descriptors[2] = context.last_vert_texture_descriptor;
+
+    // the fragment textures are pushed in the command buffer when possible
+    const bool push_frag_textures = state.support_push_descriptor && fragment_texture_count > 0;
+    if (push_frag_textures) {
+        // the pushed textures stay bound as long as the pipeline layout does not change
+        need_frag_descr |= (pipeline_layout != context.last_frag_push_layout);
+    } else if (need_frag_descr) {
+        const auto textures = get_textures(context.fragment_textures, fragment_texture_count);
+        context.last_frag_texture_descriptor = retrieve_texture_descriptor(context, false, fragment_texture_count, textures.data());
     }
+    descriptors[3] = context.last_frag_texture_descriptor;
 
     const uint32_t dynamic_offset_count = state.features.enable_memory_mapping ? 2U : 4U;
     const uint32_t dynamic_offsets[] = {
@@ -250,8 +273,37 @@ static void draw_bind_descriptors(VKContext &context, MemState &mem) {
         context.fragment_uniform_stream_ring_buffer.data_offset
     };
 
-    context.render_cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipeline_layout, 0,
-        descriptors.size(), descriptors.data(), dynamic_offset_count, dynamic_offsets);
+    // the descriptors are the same most of the time for consecutive draws
+    const uint32_t descriptor_count = push_frag_textures ? 3U : 4U;
+    if (pipeline_layout != context.bound_pipeline_layout
+        || !std::equal(descriptors.begin(), descriptors.begin() + descriptor_count, context.bound_descriptor_sets.begin())
+        || !std::equal(dynamic_offsets, dynamic_offsets + dynamic_offset_count, context.bound_dynamic_offsets.begin())) {
+        context.flush_pending_draws();
+        context.render_cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipeline_layout, 0,
+            descriptor_count, descriptors.data(), dynamic_offset_count, dynamic_offsets);
+
+        context.bound_pipeline_layout = pipeline_layout;
+        context.bound_descriptor_sets = descriptors;
+        std::copy_n(dynamic_offsets, dynamic_offset_count, context.bound_dynamic_offsets.begin());
+    }
+
+    if (push_frag_textures && need_frag_descr) {
+        context.flush_pending_draws();
+        const auto textures = get_textures(context.fragment_textures, fragment_texture_count);
+        std::array<vk::WriteDescriptorSet, 16> write_descrs;
+        for (uint32_t i = 0; i < fragment_texture_count; i++) {
+            write_descrs[i] = vk::WriteDescriptorSet{
+                .dstBinding = i,
+                .dstArrayElement = 0,
+                .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+            };
+            write_descrs[i].setImageInfo(textures[i]);
+        }
+        context.render_cmd.pushDescriptorSetKHR(vk::PipelineBindPoint::eGraphics, pipeline_layout, 3,
+            vk::ArrayProxy<const vk::WriteDescriptorSet>(fragment_texture_count, write_descrs.data()));
+        state.frame_stats.descriptor_writes += fragment_texture_count;
+        context.last_frag_push_layout = pipeline_layout;
+    }
 }
 
 // vertex count is only used with double buffer mapping
@@ -326,7 +378,17 @@ static void bind_vertex_streams(VKContext &context, MemState &mem, uint32_t inst
         }
     }
 
+    if (max_stream_idx == context.bound_vertex_stream_count
+        && std::equal(context.vertex_stream_buffers, context.vertex_stream_buffers + max_stream_idx, context.bound_vertex_stream_buffers)
+        && std::equal(context.vertex_stream_offsets, context.vertex_stream_offsets + max_stream_idx, context.bound_vertex_stream_offsets))
+        return;
+
+    context.flush_pending_draws();
     context.render_cmd.bindVertexBuffers(0, max_stream_idx, context.vertex_stream_buffers, context.vertex_stream_offsets);
+
+    context.bound_vertex_stream_count = max_stream_idx;
+    std::copy_n(context.vertex_stream_buffers, max_stream_idx, context.bound_vertex_stream_buffers);
+    std::copy_n(context.vertex_stream_offsets, max_stream_idx, context.bound_vertex_stream_offsets);
 }
 
 void draw(VKContext &context, SceGxmPrimitiveType type, SceGxmIndexFormat format,
@@ -360,11 +422,13 @@ void draw(VKContext &context, SceGxmPrimitiveType type, SceGxmIndexFormat format
             .image = context.current_color_base_image->image,
             .subresourceRange = vkutil::color_subresource_range
         };
+        context.flush_pending_draws();
         context.render_cmd.pipelineBarrier(vk::PipelineStageFlagBits::eColorAttachmentOutput, vk::PipelineStageFlagBits::eFragmentShader,
             vk::DependencyFlagBits::eByRegion, {}, {}, barrier);
     } else if (context.state.features.support_shader_interlock
         && fragment_program_gxp.is_frag_color_used() != context.last_draw_was_framebuffer_fetch) {
         // restart the render pass to act as a barrier
+        context.flush_pending_draws();
         context.render_cmd.endRenderPass();
 
         if (fragment_program_gxp.is_frag_color_used()) {
@@ -388,6 +452,7 @@ void draw(VKContext &context, SceGxmPrimitiveType type, SceGxmIndexFormat format
 
         context.visibility_max_used_idx = std::max(context.visibility_max_used_idx, context.current_query_idx);
 
+        context.flush_pending_draws();
         const vk::QueryControlFlags control_flags = (context.is_query_op_increment && context.state.physical_device_features.occlusionQueryPrecise) ? vk::QueryControlFlagBits::ePrecise : vk::QueryControlFlags();
         context.render_cmd.beginQuery(context.current_visibility_buffer->query_pool, context.current_query_idx, control_flags);
         context.is_in_query = true;
@@ -406,8 +471,10 @@ void draw(VKContext &context, SceGxmPrimitiveType type, SceGxmIndexFormat format
         if (new_pipeline != context.current_pipeline) {
             context.current_pipeline = new_pipeline;
 
-            if (new_pipeline != nullptr)
+            if (new_pipeline != nullptr) {
+                context.flush_pending_draws();
                 context.render_cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, context.current_pipeline);
+            }
         }
     }
 
@@ -473,6 +540,11 @@ void draw(VKContext &context, SceGxmPrimitiveType type, SceGxmIndexFormat format
         memcpy(&context.prev_frag_ublock, &frag_ublock, sizeof(frag_ublock));
     }
 
+    if (!use_memory_mapping) {
+        upload_uniform_storage(context, context.vertex_uniform_staging, context.vertex_uniform_stream_ring_buffer, static_cast<uint32_t>(vert_render_data->max_total_uniform_buffer_storage * 4));
+        upload_uniform_storage(context, context.fragment_uniform_staging, context.fragment_uniform_stream_ring_buffer, static_cast<uint32_t>(frag_render_data->max_total_uniform_buffer_storage * 4));
+    }
+
     // create, update and bind descriptors (uniforms and textures)
     draw_bind_descriptors(context, mem);
 
@@ -480,6 +552,8 @@ void draw(VKContext &context, SceGxmPrimitiveType type, SceGxmIndexFormat format
     vk::IndexType index_type = (format == SCE_GXM_INDEX_FORMAT_U16) ? vk::IndexType::eUint16 : vk::IndexType::eUint32;
     const size_t index_size = (format == SCE_GXM_INDEX_FORMAT_U16) ? 2 : 4;
 
+    vk::Buffer index_buffer;
+    vk::DeviceSize index_offset;
     uint32_t max_index = 0;
     if (use_memory_mapping) {
         auto [buffer, offset] = context.state.get_matching_mapping(indices);
@@ -498,20 +572,40 @@ void draw(VKContext &context, SceGxmPrimitiveType type, SceGxmIndexFormat format
             }
             max_index = trapped_buffer->extra;
         }
-        context.render_cmd.bindIndexBuffer(buffer, offset, index_type);
+        index_buffer = buffer;
+        index_offset = offset;
     } else {
         const size_t index_buffer_size = index_size * count;
         context.index_stream_ring_buffer.allocate(context.prerender_cmd, index_buffer_size, indices_ptr);
-        context.render_cmd.bindIndexBuffer(context.index_stream_ring_buffer.handle(), context.index_stream_ring_buffer.data_offset, index_type);
+        index_buffer = context.index_stream_ring_buffer.handle();
+        index_offset = context.index_stream_ring_buffer.data_offset;
+    }
+
+    // the index buffer is bound at the beginning of the buffer when possible,
+    // so that draws using other parts of it do not need to bind it again
+    const vk::DeviceSize index_bind_offset = (index_offset % index_size == 0) ? 0 : index_offset;
+    if (index_buffer != context.bound_index_buffer || index_bind_offset != context.bound_index_offset || index_type != context.bound_index_type) {
+        context.flush_pending_draws();
+        context.render_cmd.bindIndexBuffer(index_buffer, index_bind_offset, index_type);
+
+        context.bound_index_buffer = index_buffer;
+        context.bound_index_offset = index_bind_offset;
+        context.bound_index_type = index_type;
     }
 
     // bind the vertex streams
     bind_vertex_streams(context, mem, instance_count, max_index);
 
-    context.render_cmd.drawIndexed(count, instance_count, 0, 0, 0);
+    // nothing has been recorded since the previous draw if it is still pending, this draw is then merged with it
+    if (context.pending_draws.size() >= context.state.max_draw_indirect_count)
+        context.flush_pending_draws();
 
-    context.vertex_uniform_storage_allocated = false;
-    context.fragment_uniform_storage_allocated = false;
+    context.pending_draws.push_back(vk::DrawIndexedIndirectCommand{
+        .indexCount = static_cast<uint32_t>(count),
+        .instanceCount = instance_count,
+        .firstIndex = static_cast<uint32_t>((index_offset - index_bind_offset) / index_size),
+        .vertexOffset = 0,
+        .firstInstance = 0 });
 }
 
 } // namespace renderer::vulkan
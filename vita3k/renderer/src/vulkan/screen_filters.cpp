@@ -43,6 +43,7 @@ SinglePassScreenFilter::SinglePassScreenFilter(ScreenRenderer &screen)
 SinglePassScreenFilter::~SinglePassScreenFilter() {
     vk::Device device = screen.state.device;
     // this will only happen when the user changes the option in the GUI, we can afford to waitIdle
+    screen.state.wait_for_submissions();
     device.waitIdle();
     device.destroy(pipeline);
     device.destroy(pipeline_layout);
@@ -380,6 +381,7 @@ struct RcasConstant {
 
 FSRScreenFilter::~FSRScreenFilter() {
     vk::Device device = screen.state.device;
+    screen.state.wait_for_submissions();
     device.waitIdle();
 
     device.destroy(sampler);
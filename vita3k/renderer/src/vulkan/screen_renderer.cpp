@@ -256,6 +256,9 @@ void ScreenRenderer::cleanup() {
 static constexpr uint64_t next_image_timeout = std::numeric_limits<uint64_t>::max();
 
 bool ScreenRenderer::acquire_swapchain_image(bool start_render_pass) {
+    // the frame is presented after the scenes rendering it
+    state.wait_for_submissions();
+
     if (!has_surface) {
         swapchain_image_idx = 0xDEADBEAF;
         return false;
@@ -373,6 +376,8 @@ void ScreenRenderer::render(vk::ImageView image_view, vk::ImageLayout layout, co
 }
 
 void ScreenRenderer::swap_window() {
+    state.wait_for_submissions();
+
     if (!current_cmd_buffer) {
         swapchain_image_idx = ~0;
         return;
@@ -73,6 +73,7 @@ void sync_clipping(VKContext &context) {
     if (!context.is_recording)
         return;
 
+    context.flush_pending_draws();
     context.render_cmd.setScissor(0, context.scissor);
 }
 
@@ -94,6 +95,7 @@ void sync_stencil_func(VKContext &context, const bool is_back) {
         state = is_back ? &context.record.back_stencil_state_values : &context.record.front_stencil_state_values;
     }
 
+    context.flush_pending_draws();
     context.render_cmd.setStencilCompareMask(face, state->compare_mask);
     context.render_cmd.setStencilReference(face, state->ref);
     context.render_cmd.setStencilWriteMask(face, state->write_mask);
@@ -103,6 +105,7 @@ void sync_depth_bias(VKContext &context) {
     if (!context.is_recording)
         return;
 
+    context.flush_pending_draws();
     context.render_cmd.setDepthBias(static_cast<float>(context.record.depth_bias_unit), 0.0, static_cast<float>(context.record.depth_bias_slope));
 }
 
@@ -124,6 +127,7 @@ void sync_depth_data(VKContext &context) {
         .baseArrayLayer = 0,
         .layerCount = 1
     };
+    context.flush_pending_draws();
     context.render_cmd.clearAttachments(clear_attachment, clear_rect);
 }
 
@@ -145,6 +149,7 @@ void sync_stencil_data(VKContext &context, const MemState &mem) {
         .baseArrayLayer = 0,
         .layerCount = 1
     };
+    context.flush_pending_draws();
     context.render_cmd.clearAttachments(clear_attachment, clear_rect);
 }
 
@@ -152,8 +157,10 @@ void sync_point_line_width(VKContext &context, const bool is_front) {
     if (!context.is_recording)
         return;
 
-    if (is_front && context.state.physical_device_features.wideLines)
+    if (is_front && context.state.physical_device_features.wideLines) {
+        context.flush_pending_draws();
         context.render_cmd.setLineWidth(context.record.line_width * context.state.res_multiplier);
+    }
 }
 
 void sync_viewport_flat(VKContext &context) {
@@ -168,6 +175,7 @@ void sync_viewport_flat(VKContext &context) {
 
     if (!context.is_recording)
         return;
+    context.flush_pending_draws();
     context.render_cmd.setViewport(0, context.viewport);
 }
 
@@ -199,6 +207,7 @@ void sync_viewport_real(VKContext &context, const float xOffset, const float yOf
 
     if (!context.is_recording)
         return;
+    context.flush_pending_draws();
     context.render_cmd.setViewport(0, context.viewport);
 }
 
@@ -242,6 +251,7 @@ void sync_visibility_index(VKContext &context, bool enable, uint32_t index, bool
 
     if (!enable) {
         if (context.is_in_query) {
+            context.flush_pending_draws();
             context.render_cmd.endQuery(context.current_visibility_buffer->query_pool, context.current_query_idx);
             context.is_in_query = false;
         }
@@ -252,6 +262,7 @@ void sync_visibility_index(VKContext &context, bool enable, uint32_t index, bool
 
     // do not end the query if it's the same index
     if (context.is_in_query && context.current_query_idx != index) {
+        context.flush_pending_draws();
         context.render_cmd.endQuery(context.current_visibility_buffer->query_pool, context.current_query_idx);
         context.is_in_query = false;
     }
@@ -176,6 +176,8 @@ void VKTextureCache::prepare_staging_buffer(bool is_configure) {
             context->prerender_cmd.end();
             context->cmdbuffers_to_submit.push_back(context->prerender_cmd);
 
+            // the previous scenes must be submitted first
+            state.wait_for_submissions();
             vk::SubmitInfo submit_info{};
             submit_info.setCommandBuffers(context->cmdbuffers_to_submit);
             state.general_queue.submit(submit_info, current_fence);
@@ -521,6 +523,20 @@ void VKTextureCache::upload_done() {
     is_texture_transfer_ready = false;
 }
 
+void VKTextureCache::clear_texture() {
+    // configure_texture has already put the image in the transfer layout
+    assert(is_texture_transfer_ready);
+
+    vk::ImageSubresourceRange range{
+        .aspectMask = vk::ImageAspectFlagBits::eColor,
+        .baseMipLevel = 0,
+        .levelCount = current_texture->mip_count,
+        .baseArrayLayer = 0,
+        .layerCount = current_texture->is_cube ? 6U : 1U
+    };
+    cmd_buffer.clearColorImage(current_texture->texture.image, vk::ImageLayout::eTransferDstOptimal, vk::ClearColorValue{}, range);
+}
+
 void VKTextureCache::configure_sampler(size_t index, const SceGxmTexture &texture, bool no_linear) {
     vk::Sampler &sampler = samplers[index];
     if (sampler) {
@@ -0,0 +1,61 @@
+// Vita3K emulator project
+// Copyright (C) 2024 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <renderer/program_registry.h>
+
+#include <gxm/types.h>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+using namespace renderer;
+
+// a fake program of the given size, only its content matters to the registry
+static std::vector<uint8_t> make_program(const uint32_t size, const uint8_t value) {
+    std::vector<uint8_t> program(size, value);
+    memcpy(program.data() + offsetof(SceGxmProgram, size), &size, sizeof(size));
+    return program;
+}
+
+static const SceGxmProgram &as_program(const std::vector<uint8_t> &program) {
+    return *reinterpret_cast<const SceGxmProgram *>(program.data());
+}
+
+TEST(program_registry, same_content_same_id) {
+    ProgramRegistry registry;
+    const std::vector<uint8_t> program_a = make_program(256, 1);
+    const std::vector<uint8_t> program_a_copy = make_program(256, 1);
+    const std::vector<uint8_t> program_b = make_program(256, 2);
+
+    const uint32_t id_a = registry.register_program(as_program(program_a));
+    EXPECT_EQ(registry.register_program(as_program(program_a_copy)), id_a);
+    EXPECT_NE(registry.register_program(as_program(program_b)), id_a);
+
+    const Sha256Hash hash_a = sha256(program_a.data(), program_a.size());
+    EXPECT_EQ(registry.get_hash(id_a), hash_a);
+}
+
+TEST(program_registry, known_hash_before_register) {
+    ProgramRegistry registry;
+    const std::vector<uint8_t> program = make_program(128, 3);
+
+    // the shader cache is read before the application registers its programs
+    const uint32_t id = registry.get_id(sha256(program.data(), program.size()));
+    EXPECT_EQ(registry.register_program(as_program(program)), id);
+}
@@ -0,0 +1,105 @@
+// Vita3K emulator project
+// Copyright (C) 2024 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <renderer/shader_pack.h>
+
+#include <gtest/gtest.h>
+
+using namespace renderer;
+
+class shader_pack : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path = fs::temp_directory_path() / fs::unique_path("vita3k-shaders-%%%%-%%%%") / ShaderPack::FILE_NAME;
+    }
+
+    void TearDown() override {
+        fs::remove_all(path.parent_path());
+    }
+
+    static Sha256Hash make_hash(uint8_t value) {
+        Sha256Hash hash{};
+        hash.fill(value);
+        return hash;
+    }
+
+    fs::path path;
+};
+
+TEST_F(shader_pack, store_then_load_after_reopen) {
+    const std::vector<uint32_t> spirv = { 0x07230203, 1, 2, 3 };
+    const std::string glsl = "void main() {}";
+    {
+        ShaderPack pack;
+        pack.open(path, 0);
+        pack.store(make_hash(1), 2, spirv.data(), spirv.size() * sizeof(uint32_t));
+        pack.store(make_hash(2), 0, glsl.data(), glsl.size());
+
+        // available before the next boot
+        EXPECT_EQ(pack.load_spirv(make_hash(1), 2), spirv);
+        EXPECT_TRUE(pack.load_spirv(make_hash(1), 1).empty());
+    }
+
+    ShaderPack pack;
+    pack.open(path, 0);
+    EXPECT_EQ(pack.size(), 2);
+    EXPECT_EQ(pack.load_spirv(make_hash(1), 2), spirv);
+    EXPECT_EQ(pack.load_glsl(make_hash(2), 0), glsl);
+    EXPECT_TRUE(pack.load_glsl(make_hash(3), 0).empty());
+}
+
+TEST_F(shader_pack, features_mask_selects_the_variant) {
+    const std::vector<uint32_t> first = { 1, 2 };
+    const std::vector<uint32_t> second = { 3, 4, 5 };
+    {
+        ShaderPack pack;
+        pack.open(path, 1);
+        pack.store(make_hash(1), 2, first.data(), first.size() * sizeof(uint32_t));
+    }
+    {
+        ShaderPack pack;
+        pack.open(path, 2);
+        EXPECT_TRUE(pack.load_spirv(make_hash(1), 2).empty());
+        pack.store(make_hash(1), 2, second.data(), second.size() * sizeof(uint32_t));
+    }
+
+    // the variant of the first features mask is still there
+    ShaderPack pack;
+    pack.open(path, 1);
+    EXPECT_EQ(pack.load_spirv(make_hash(1), 2), first);
+    pack.open(path, 2);
+    EXPECT_EQ(pack.load_spirv(make_hash(1), 2), second);
+}
+
+TEST_F(shader_pack, superseded_shaders_are_compacted) {
+    std::vector<uint32_t> spirv(256);
+    {
+        ShaderPack pack;
+        pack.open(path, 0);
+        // each store replaces the previous one
+        for (uint32_t i = 0; i < 512; i++) {
+            spirv[0] = i;
+            pack.store(make_hash(1), 2, spirv.data(), spirv.size() * sizeof(uint32_t));
+        }
+    }
+    const uint64_t size_before = fs::file_size(path);
+
+    ShaderPack pack;
+    pack.open(path, 0);
+    EXPECT_LT(fs::file_size(path), size_before / 100);
+    EXPECT_EQ(pack.load_spirv(make_hash(1), 2), spirv);
+}
@@ -0,0 +1,131 @@
+// Vita3K emulator project
+// Copyright (C) 2024 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <renderer/functions.h>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace renderer::texture;
+
+static constexpr uint8_t TEXEL_BITS[] = { 8, 16, 24, 32, 64, 128 };
+
+static std::vector<uint8_t> random_bytes(const size_t size, const uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> bytes(size);
+    for (uint8_t &byte : bytes)
+        byte = static_cast<uint8_t>(rng());
+
+    return bytes;
+}
+
+// texel by texel conversions, as the texture cache used to do it
+static void swizzled_to_linear_reference(uint8_t *dest, const uint8_t *src, uint16_t width, uint16_t height, uint32_t bytes_per_pixel) {
+    for (uint16_t y = 0; y < height; y++) {
+        for (uint16_t x = 0; x < width; x++)
+            memcpy(dest + (y * width + x) * bytes_per_pixel, src + encode_morton(x, y, width, height) * bytes_per_pixel, bytes_per_pixel);
+    }
+}
+
+static void tiled_to_linear_reference(uint8_t *dest, const uint8_t *src, uint16_t width, uint16_t height, uint32_t bytes_per_pixel) {
+    const uint32_t width_in_tiles = (width + 31) >> 5;
+    for (uint16_t y = 0; y < height; y++) {
+        for (uint16_t x = 0; x < width; x++) {
+            const uint32_t texel_offset_in_tile = (x & 0b11111) | ((y & 0b11111) << 5);
+            const uint32_t tile_address = (x >> 5) + width_in_tiles * (y >> 5);
+            memcpy(dest + (y * width + x) * bytes_per_pixel, src + ((tile_address << 10) | texel_offset_in_tile) * bytes_per_pixel, bytes_per_pixel);
+        }
+    }
+}
+
+TEST(swizzle, swizzled_matches_reference) {
+    constexpr uint16_t sizes[][2] = { { 1, 1 }, { 2, 8 }, { 4, 4 }, { 8, 32 }, { 64, 16 }, { 128, 128 } };
+    for (const uint8_t bits : TEXEL_BITS) {
+        const uint32_t bytes_per_pixel = bits / 8;
+        for (const auto &[width, height] : sizes) {
+            const size_t size = static_cast<size_t>(width) * height * bytes_per_pixel;
+            const std::vector<uint8_t> swizzled = random_bytes(size, width * height + bits);
+            std::vector<uint8_t> expected(size);
+            std::vector<uint8_t> linear(size);
+            swizzled_to_linear_reference(expected.data(), swizzled.data(), width, height, bytes_per_pixel);
+            swizzled_texture_to_linear_texture(linear.data(), swizzled.data(), width, height, bits);
+            ASSERT_EQ(linear, expected) << "bpp " << int(bits) << " size " << width << "x" << height;
+
+            std::vector<uint8_t> back(size);
+            linear_texture_to_swizzled_texture(back.data(), linear.data(), width, height, bits);
+            ASSERT_EQ(back, swizzled) << "bpp " << int(bits) << " size " << width << "x" << height;
+        }
+    }
+}
+
+TEST(swizzle, tiled_matches_reference) {
+    constexpr uint16_t sizes[][2] = { { 1, 1 }, { 32, 32 }, { 40, 37 }, { 96, 64 }, { 200, 33 } };
+    for (const uint8_t bits : TEXEL_BITS) {
+        const uint32_t bytes_per_pixel = bits / 8;
+        for (const auto &[width, height] : sizes) {
+            // the tiled texture is made of whole tiles
+            const size_t tiled_size = static_cast<size_t>((width + 31) & ~31) * ((height + 31) & ~31) * bytes_per_pixel;
+            const size_t linear_size = static_cast<size_t>(width) * height * bytes_per_pixel;
+            const std::vector<uint8_t> tiled = random_bytes(tiled_size, width * height + bits);
+            std::vector<uint8_t> expected(linear_size);
+            std::vector<uint8_t> linear(linear_size);
+            tiled_to_linear_reference(expected.data(), tiled.data(), width, height, bytes_per_pixel);
+            tiled_texture_to_linear_texture(linear.data(), tiled.data(), width, height, bits);
+            ASSERT_EQ(linear, expected) << "bpp " << int(bits) << " size " << width << "x" << height;
+
+            std::vector<uint8_t> back(tiled_size);
+            linear_texture_to_tiled_texture(back.data(), linear.data(), width, height, bits);
+            std::vector<uint8_t> back_linear(linear_size);
+            tiled_to_linear_reference(back_linear.data(), back.data(), width, height, bytes_per_pixel);
+            ASSERT_EQ(back_linear, linear) << "bpp " << int(bits) << " size " << width << "x" << height;
+        }
+    }
+}
+
+// Not a correctness test: prints the conversion time next to the texel by texel version for every texel size
+TEST(swizzle, DISABLED_benchmark) {
+    constexpr uint16_t sizes[] = { 256, 512, 1024, 2048 };
+    for (const uint8_t bits : TEXEL_BITS) {
+        const uint32_t bytes_per_pixel = bits / 8;
+        for (const uint16_t size : sizes) {
+            const std::vector<uint8_t> src = random_bytes(static_cast<size_t>(size) * size * bytes_per_pixel, size);
+            std::vector<uint8_t> dst(src.size());
+            const int iterations = std::max(1, (1 << 24) / (size * size));
+
+            const auto time_ms = [&](auto convert) {
+                const auto start = std::chrono::steady_clock::now();
+                for (int i = 0; i < iterations; i++)
+                    convert();
+                const auto elapsed = std::chrono::steady_clock::now() - start;
+                return std::chrono::duration<double, std::milli>(elapsed).count() / iterations;
+            };
+
+            const double unswizzle = time_ms([&] { swizzled_texture_to_linear_texture(dst.data(), src.data(), size, size, bits); });
+            const double swizzle = time_ms([&] { linear_texture_to_swizzled_texture(dst.data(), src.data(), size, size, bits); });
+            const double untile = time_ms([&] { tiled_texture_to_linear_texture(dst.data(), src.data(), size, size, bits); });
+            const double reference = time_ms([&] { swizzled_to_linear_reference(dst.data(), src.data(), size, size, bytes_per_pixel); });
+            const double tiled_reference = time_ms([&] { tiled_to_linear_reference(dst.data(), src.data(), size, size, bytes_per_pixel); });
+            printf("%3d bpp %4dx%-4d: unswizzle %7.3f ms (texel by texel %7.3f ms), swizzle %7.3f ms, untile %7.3f ms (texel by texel %7.3f ms)\n",
+                bits, size, size, unswizzle, reference, swizzle, untile, tiled_reference);
+        }
+    }
+}
@@ -0,0 +1,112 @@
+// Vita3K emulator project
+// Copyright (C) 2024 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <renderer/texture_cache.h>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+using namespace renderer;
+
+class texture_disk_cache : public ::testing::Test {
+protected:
+    void SetUp() override {
+        folder = fs::temp_directory_path() / fs::unique_path("vita3k-decoded-%%%%-%%%%");
+    }
+
+    void TearDown() override {
+        fs::remove_all(folder);
+    }
+
+    // two levels filled with value, their sizes are not multiples of 16
+    static DecodedTexture make_texture(const uint8_t value) {
+        DecodedTexture decoded;
+        decoded.buffers.emplace_back(15 * 15 * 4, value);
+        decoded.buffers.emplace_back(7 * 7 * 4, static_cast<uint8_t>(value + 1));
+        decoded.levels.push_back({ SCE_GXM_TEXTURE_BASE_FORMAT_U8U8U8U8, 15, 15, 0, 0, 15, decoded.buffers[0].data(), decoded.buffers[0].size() });
+        decoded.levels.push_back({ SCE_GXM_TEXTURE_BASE_FORMAT_U8U8U8U8, 7, 7, 1, 0, 7, decoded.buffers[1].data(), decoded.buffers[1].size() });
+        return decoded;
+    }
+
+    // size on disk of a texture made by make_texture
+    uint64_t get_texture_file_size() {
+        DecodedTextureDiskCache cache;
+        cache.init(folder / "size");
+        cache.store(0, make_texture(0));
+        return cache.stats().total_size;
+    }
+
+    fs::path folder;
+};
+
+TEST_F(texture_disk_cache, store_then_load) {
+    DecodedTextureDiskCache cache;
+    cache.init(folder);
+
+    const DecodedTexture stored = make_texture(7);
+    cache.store(42, stored);
+
+    DecodedTexture loaded;
+    ASSERT_TRUE(cache.load(42, loaded));
+    ASSERT_EQ(loaded.levels.size(), 2);
+    for (size_t i = 0; i < 2; i++) {
+        const DecodedTextureLevel &level = loaded.levels[i];
+        EXPECT_EQ(level.mip_index, stored.levels[i].mip_index);
+        EXPECT_EQ(level.width, stored.levels[i].width);
+        ASSERT_EQ(level.size, stored.levels[i].size);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(level.pixels) % 16, 0);
+        EXPECT_EQ(memcmp(level.pixels, stored.levels[i].pixels, level.size), 0);
+    }
+
+    DecodedTexture missing;
+    EXPECT_FALSE(cache.load(43, missing));
+
+    const DecodedTextureDiskCacheStats stats = cache.stats();
+    EXPECT_EQ(stats.hits, 1);
+    EXPECT_EQ(stats.misses, 1);
+    EXPECT_EQ(stats.stores, 1);
+}
+
+TEST_F(texture_disk_cache, evicts_least_recently_used) {
+    const uint64_t texture_size = get_texture_file_size();
+    ASSERT_GT(texture_size, 0);
+    // room for two textures
+    const uint64_t max_size = texture_size * 2 + texture_size / 2;
+    {
+        DecodedTextureDiskCache cache;
+        cache.init(folder, max_size);
+        cache.store(1, make_texture(1));
+        cache.store(2, make_texture(2));
+
+        // 1 becomes the most recently used, so 2 is evicted by 3
+        DecodedTexture loaded;
+        ASSERT_TRUE(cache.load(1, loaded));
+        cache.store(3, make_texture(3));
+
+        EXPECT_EQ(cache.stats().evictions, 1);
+        EXPECT_LE(cache.stats().total_size, max_size);
+    }
+
+    // the content is still there on the next boot
+    DecodedTextureDiskCache cache;
+    cache.init(folder, max_size);
+    DecodedTexture loaded;
+    EXPECT_TRUE(cache.load(1, loaded));
+    EXPECT_FALSE(cache.load(2, loaded));
+    EXPECT_TRUE(cache.load(3, loaded));
+}
@@ -0,0 +1,60 @@
+// Vita3K emulator project
+// Copyright (C) 2024 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <renderer/uniform_staging.h>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+using namespace renderer;
+
+TEST(uniform_staging, uploads_only_on_change) {
+    UniformStaging staging;
+    const float camera[4] = { 1.f, 2.f, 3.f, 4.f };
+    const float light[2] = { 5.f, 6.f };
+
+    staging.write(0, camera, sizeof(camera));
+    staging.write(sizeof(camera), light, sizeof(light));
+    EXPECT_TRUE(staging.needs_upload(sizeof(camera) + sizeof(light)));
+    EXPECT_EQ(memcmp(staging.data() + sizeof(camera), light, sizeof(light)), 0);
+
+    // the same buffers are bound for the next draw
+    staging.write(0, camera, sizeof(camera));
+    staging.write(sizeof(camera), light, sizeof(light));
+    EXPECT_FALSE(staging.needs_upload(sizeof(camera) + sizeof(light)));
+
+    const float other_light[2] = { 5.f, 7.f };
+    staging.write(sizeof(camera), other_light, sizeof(other_light));
+    EXPECT_TRUE(staging.needs_upload(sizeof(camera) + sizeof(light)));
+    EXPECT_EQ(memcmp(staging.data() + sizeof(camera), other_light, sizeof(other_light)), 0);
+}
+
+TEST(uniform_staging, uploads_on_size_change_or_invalidate) {
+    UniformStaging staging;
+    const uint32_t block[4] = { 1, 2, 3, 4 };
+
+    staging.write(0, block, sizeof(block));
+    EXPECT_TRUE(staging.needs_upload(sizeof(block)));
+
+    // another program with a bigger storage
+    EXPECT_TRUE(staging.needs_upload(sizeof(block) * 2));
+    EXPECT_FALSE(staging.needs_upload(sizeof(block) * 2));
+
+    staging.invalidate();
+    EXPECT_TRUE(staging.needs_upload(sizeof(block) * 2));
+}
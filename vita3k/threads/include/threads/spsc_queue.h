@@ -0,0 +1,176 @@
+// Vita3K emulator project
+// Copyright (C) 2024 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#ifndef spsc_queue_h
+#define spsc_queue_h
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+struct SPSCQueueStats {
+    size_t occupancy;
+    size_t max_occupancy;
+    uint64_t producer_stall_us; ///< Total time the producer waited on a full queue
+    uint64_t consumer_stall_us; ///< Total time the consumer waited on an empty queue
+};
+
+/**
+ * \brief Bounded ring buffer with a single consumer.
+ *
+ * top()/pop() must only be called from one thread. push() can be called from several
+ * threads (every guest thread submitting to gxm), concurrent pushes are serialized by
+ * producer_mutex_ so that the ring itself only ever sees one producer at a time.
+ * The consumer never takes a lock unless it has to sleep: a waiting thread registers
+ * itself in waiters_ and the other side only touches the mutex to wake it up.
+ * Items are handed out by reference and stay valid until pop() is called.
+ */
+template <typename T, size_t Capacity>
+class SPSCQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+public:
+    SPSCQueue() = default;
+    SPSCQueue(const SPSCQueue &) = delete; // disable copying
+    SPSCQueue &operator=(const SPSCQueue &) = delete; // disable assignment
+
+    // Blocks while the queue is full, returns false if the queue was aborted
+    bool push(T &&item) {
+        const std::lock_guard<std::mutex> producer_lock(producer_mutex_);
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ == Capacity) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ == Capacity) {
+                const auto start = std::chrono::steady_clock::now();
+                wait_for([&] { return tail - head_.load(std::memory_order_acquire) < Capacity; }, std::chrono::microseconds::max());
+                producer_stall_us_.fetch_add(elapsed_us(start), std::memory_order_relaxed);
+                head_cache_ = head_.load(std::memory_order_acquire);
+            }
+        }
+        if (aborted)
+            return false;
+
+        slots_[tail & (Capacity - 1)] = std::move(item);
+        tail_.store(tail + 1, std::memory_order_release);
+        wake();
+
+        const size_t occupancy = tail + 1 - head_cache_;
+        if (occupancy > max_occupancy_.load(std::memory_order_relaxed))
+            max_occupancy_.store(occupancy, std::memory_order_relaxed);
+
+        return true;
+    }
+
+    // Returns the oldest item, waiting at most timeout for one to be pushed (forever if zero)
+    T *top(const std::chrono::microseconds timeout = std::chrono::microseconds::zero()) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_) {
+                const auto start = std::chrono::steady_clock::now();
+                wait_for([&] { return tail_.load(std::memory_order_acquire) != head; }, timeout == std::chrono::microseconds::zero() ? std::chrono::microseconds::max() : timeout);
+                consumer_stall_us_.fetch_add(elapsed_us(start), std::memory_order_relaxed);
+                tail_cache_ = tail_.load(std::memory_order_acquire);
+                if (head == tail_cache_)
+                    return nullptr;
+            }
+        }
+        if (aborted)
+            return nullptr;
+
+        return &slots_[head & (Capacity - 1)];
+    }
+
+    // Drops the item returned by the last top() call
+    void pop() {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        slots_[head & (Capacity - 1)] = T();
+        head_.store(head + 1, std::memory_order_release);
+        wake();
+    }
+
+    size_t size() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    SPSCQueueStats stats() const {
+        return { size(), max_occupancy_.load(std::memory_order_relaxed),
+            producer_stall_us_.load(std::memory_order_relaxed), consumer_stall_us_.load(std::memory_order_relaxed) };
+    }
+
+    void abort() {
+        aborted = true;
+        const std::lock_guard<std::mutex> lock(mutex_);
+        cond_.notify_all();
+    }
+
+private:
+    static uint64_t elapsed_us(const std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    template <typename Pred>
+    void wait_for(Pred ready, const std::chrono::microseconds timeout) {
+        waiters_.fetch_add(1, std::memory_order_seq_cst);
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            const auto pred = [&] { return aborted || ready(); };
+            if (timeout == std::chrono::microseconds::max())
+                cond_.wait(lock, pred);
+            else
+                cond_.wait_for(lock, timeout, pred);
+        }
+        waiters_.fetch_sub(1, std::memory_order_seq_cst);
+    }
+
+    void wake() {
+        // Pairs with the waiters_ increment: either the waiter sees the new index, or we see the waiter
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_relaxed) == 0)
+            return;
+
+        const std::lock_guard<std::mutex> lock(mutex_);
+        cond_.notify_all();
+    }
+
+    // Consumer side
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head_{ 0 };
+    size_t tail_cache_ = 0;
+
+    // Producer side, only accessed with producer_mutex_ held
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail_{ 0 };
+    size_t head_cache_ = 0;
+    std::mutex producer_mutex_;
+    std::atomic<size_t> max_occupancy_{ 0 };
+    std::atomic<uint64_t> producer_stall_us_{ 0 };
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> consumer_stall_us_{ 0 };
+    std::atomic<int> waiters_{ 0 };
+    std::atomic<bool> aborted{ false };
+    std::mutex mutex_;
+    std::condition_variable cond_;
+
+    alignas(CACHE_LINE_SIZE) std::array<T, Capacity> slots_{};
+};
+
+#endif /* spsc_queue_h */
@@ -0,0 +1,118 @@
+// Vita3K emulator project
+// Copyright (C) 2024 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#ifndef thread_pool_h
+#define thread_pool_h
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * \brief Fixed set of worker threads executing jobs in submission order.
+ *
+ * Jobs which have not been started when the pool is destroyed are dropped,
+ * their future then reports a broken promise.
+ */
+class ThreadPool {
+public:
+    ThreadPool() = default;
+    ThreadPool(const ThreadPool &) = delete; // disable copying
+    ThreadPool &operator=(const ThreadPool &) = delete; // disable assignment
+
+    ~ThreadPool() {
+        stop();
+    }
+
+    // Launches nb_threads workers, 0 means one less than the number of logical cores
+    void start(unsigned int nb_threads = 0) {
+        if (!workers.empty())
+            return;
+
+        if (nb_threads == 0)
+            nb_threads = std::max(std::thread::hardware_concurrency(), 2U) - 1;
+
+        aborted = false;
+        for (unsigned int i = 0; i < nb_threads; i++)
+            workers.emplace_back(&ThreadPool::worker_thread, this);
+    }
+
+    void stop() {
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            aborted = true;
+            jobs.clear();
+        }
+        cond.notify_all();
+
+        for (std::thread &worker : workers)
+            worker.join();
+        workers.clear();
+    }
+
+    bool is_running() const {
+        return !workers.empty();
+    }
+
+    size_t size() const {
+        return workers.size();
+    }
+
+    template <typename F>
+    std::future<std::invoke_result_t<F>> submit(F &&job) {
+        auto task = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::forward<F>(job));
+        auto result = task->get_future();
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            jobs.emplace_back([task] { (*task)(); });
+        }
+        cond.notify_one();
+
+        return result;
+    }
+
+private:
+    void worker_thread() {
+        while (true) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cond.wait(lock, [&] { return aborted || !jobs.empty(); });
+                if (aborted)
+                    return;
+
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+            job();
+        }
+    }
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> jobs;
+    bool aborted = false;
+    std::mutex mutex;
+    std::condition_variable cond;
+};
+
+#endif /* thread_pool_h */
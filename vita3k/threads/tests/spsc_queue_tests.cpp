@@ -0,0 +1,84 @@
+// Vita3K emulator project
+// Copyright (C) 2024 Vita3K team
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+#include <threads/spsc_queue.h>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+TEST(spsc_queue, push_then_pop_in_order) {
+    SPSCQueue<int, 4> queue;
+    for (int i = 1; i <= 4; i++)
+        ASSERT_TRUE(queue.push(int(i)));
+    ASSERT_EQ(queue.size(), 4);
+
+    for (int i = 1; i <= 4; i++) {
+        int *item = queue.top();
+        ASSERT_NE(item, nullptr);
+        ASSERT_EQ(*item, i);
+        queue.pop();
+    }
+    ASSERT_EQ(queue.top(std::chrono::microseconds(100)), nullptr);
+}
+
+TEST(spsc_queue, abort_wakes_up_the_consumer) {
+    SPSCQueue<int, 4> queue;
+    std::thread consumer([&] {
+        ASSERT_EQ(queue.top(), nullptr);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    queue.abort();
+    consumer.join();
+}
+
+// guest threads submit command lists concurrently, nothing may be lost or reordered per thread
+TEST(spsc_queue, multiple_producers_stress) {
+    constexpr uint32_t nb_producers = 8;
+    constexpr uint32_t items_per_producer = 20000;
+
+    // small capacity so that the producers keep waiting on a full queue
+    SPSCQueue<uint64_t, 8> queue;
+    std::vector<std::thread> producers;
+    for (uint32_t producer = 0; producer < nb_producers; producer++) {
+        producers.emplace_back([&queue, producer] {
+            // 0 is the value of an empty slot, start the sequence at 1
+            for (uint32_t i = 1; i <= items_per_producer; i++)
+                ASSERT_TRUE(queue.push((static_cast<uint64_t>(producer) << 32) | i));
+        });
+    }
+
+    std::vector<uint32_t> last_seen(nb_producers, 0);
+    for (uint32_t received = 0; received < nb_producers * items_per_producer; received++) {
+        uint64_t *item = queue.top();
+        ASSERT_NE(item, nullptr);
+        const uint32_t producer = static_cast<uint32_t>(*item >> 32);
+        const uint32_t sequence = static_cast<uint32_t>(*item);
+        ASSERT_LT(producer, nb_producers);
+        ASSERT_EQ(sequence, last_seen[producer] + 1);
+        last_seen[producer] = sequence;
+        queue.pop();
+    }
+
+    for (std::thread &producer : producers)
+        producer.join();
+
+    ASSERT_EQ(queue.size(), 0);
+    for (const uint32_t last : last_seen)
+        ASSERT_EQ(last, items_per_producer);
+}